@@ -3,9 +3,12 @@
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 // inspired by dwm's gettextprop()
 char* read_window_property(Display* dpy, Window window, Atom atom) {
@@ -57,3 +60,157 @@ void argv_free(int argc, char** argv) {
     }
     free(argv);
 }
+
+// prepares 'reader' for reading 'delim'-separated lines from 'fd'
+void line_reader_init(LineReader* reader, int fd, int delim) {
+    reader->fd = fd;
+    reader->delim = delim;
+    reader->eof = false;
+    reader->start = 0;
+    reader->end = 0;
+}
+
+bool line_reader_ready(LineReader* reader) {
+    if (reader->eof) {
+        return true;
+    }
+    if (memchr(reader->buf + reader->start, reader->delim,
+               reader->end - reader->start)) {
+        // a complete line is buffered already
+        return true;
+    }
+    struct pollfd pfd = { reader->fd, POLLIN, 0 };
+    return poll(&pfd, 1, 0) > 0;
+}
+
+// refill the buffer, return false on EOF or error
+static bool line_reader_fill(LineReader* reader) {
+    if (reader->eof) {
+        return false;
+    }
+    ssize_t got;
+    do {
+        got = read(reader->fd, reader->buf, sizeof(reader->buf));
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) {
+        reader->eof = true;
+        return false;
+    }
+    reader->start = 0;
+    reader->end = (size_t)got;
+    return true;
+}
+
+// reads the next chunk up to the next 'delim' character (which is not
+// included in the result). The returned string has to be freed by the
+// caller.
+char* line_reader_next(LineReader* reader) {
+    size_t size = 128;
+    size_t len = 0;
+    char* buf = malloc(size);
+    if (!buf) {
+        return NULL;
+    }
+    bool found_delim = false;
+    while (!found_delim) {
+        if (reader->start == reader->end && !line_reader_fill(reader)) {
+            break;
+        }
+        char* chunk = reader->buf + reader->start;
+        size_t available = reader->end - reader->start;
+        char* delim = memchr(chunk, reader->delim, available);
+        size_t chunk_len = delim ? (size_t)(delim - chunk) : available;
+        if (len + chunk_len + 1 > size) {
+            while (len + chunk_len + 1 > size) {
+                size *= 2;
+            }
+            char* bigger = realloc(buf, size);
+            if (!bigger) {
+                free(buf);
+                return NULL;
+            }
+            buf = bigger;
+        }
+        memcpy(buf + len, chunk, chunk_len);
+        len += chunk_len;
+        reader->start += chunk_len;
+        if (delim) {
+            // skip the delimiter
+            reader->start++;
+            found_delim = true;
+        }
+    }
+    if (!found_delim && len == 0) {
+        free(buf);
+        return NULL;
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+// splits 'line' into words at whitespace, similar to a posix shell: single
+// quotes preserve everything literally, and within double quotes and outside
+// of quotes a backslash escapes the next character. Returns false if a quote
+// is not terminated. On success, argv has to be freed with argv_free().
+bool split_command(const char* line, int* argc, char*** argv) {
+    // no word is longer than the line itself
+    char* word = malloc(strlen(line) + 1);
+    if (!word) {
+        return false;
+    }
+    int count = 0;
+    char** words = NULL;
+    const char* pos = line;
+    while (true) {
+        while (*pos == ' ' || *pos == '\t' || *pos == '\n') {
+            pos++;
+        }
+        if (*pos == '\0') {
+            break;
+        }
+        size_t len = 0;
+        char quote = '\0';
+        for (; *pos != '\0'; pos++) {
+            if (quote == '\'') {
+                if (*pos == '\'') {
+                    quote = '\0';
+                } else {
+                    word[len++] = *pos;
+                }
+            } else if (*pos == '\\' && pos[1] != '\0') {
+                pos++;
+                word[len++] = *pos;
+            } else if (quote == '"') {
+                if (*pos == '"') {
+                    quote = '\0';
+                } else {
+                    word[len++] = *pos;
+                }
+            } else if (*pos == '\'' || *pos == '"') {
+                quote = *pos;
+            } else if (*pos == ' ' || *pos == '\t' || *pos == '\n') {
+                break;
+            } else {
+                word[len++] = *pos;
+            }
+        }
+        if (quote != '\0') {
+            argv_free(count, words);
+            free(word);
+            return false;
+        }
+        word[len] = '\0';
+        char** bigger = realloc(words, sizeof(char*) * (count + 1));
+        if (!bigger) {
+            argv_free(count, words);
+            free(word);
+            return false;
+        }
+        words = bigger;
+        words[count++] = strdup(word);
+    }
+    free(word);
+    *argc = count;
+    *argv = words;
+    return true;
+}
@@ -3,11 +3,31 @@
 
 #include <X11/X.h>
 #include <X11/Xlib.h>
+#include <stdbool.h>
+#include <stdio.h>
 
 // return a window property or NULL on error
 char* read_window_property(Display* dpy, Window window, Atom atom);
 char** argv_duplicate(int argc, char** argv);
 void argv_free(int argc, char** argv);
+// reads delimited lines from a file descriptor. In contrast to stdio, it
+// can tell whether the next line is available without blocking.
+typedef struct {
+    int fd;
+    int delim;
+    bool eof;
+    char buf[4096];
+    size_t start; // the unread bytes in buf are from start to end
+    size_t end;
+} LineReader;
+
+void line_reader_init(LineReader* reader, int fd, int delim);
+// whether line_reader_next() would return without blocking
+bool line_reader_ready(LineReader* reader);
+// read up to the next delim or EOF, return NULL if there is nothing left
+char* line_reader_next(LineReader* reader);
+// split a command line into words, respecting quotes and backslashes
+bool split_command(const char* line, int* argc, char*** argv);
 
 
 #endif
@@ -7,10 +7,15 @@
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <errno.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 #include "../src/ipc-protocol.h"
 #include "client-utils.h"
@@ -24,9 +29,21 @@ struct HCConnection {
     Atom        atom_args;
     Atom        atom_output;
     Atom        atom_status;
+    Atom        atom_socket;
+    Atom        atom_token;
     Window      root;
+    int         socket_fd; // connection to the ipc socket or -1
+    bool        socket_checked; // whether we tried to connect to the socket
+    uint32_t    next_request_id; // id for the next call on the socket
+    int         output_format; // HERBST_IPC_FORMAT_* requested for calls
+    bool        hooks_subscribed; // whether hooks are read from the socket
+    uint32_t    next_hook_seq; // expected sequence number of the next hook
 };
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 HCConnection* hc_connect() {
     Display* display = XOpenDisplay(NULL);
     if (display == NULL) {
@@ -47,9 +64,22 @@ HCConnection* hc_connect_to_display(Display* display) {
     memset(con, 0, sizeof(HCConnection));
     con->display = display;
     con->root = DefaultRootWindow(con->display);
-    con->atom_args = XInternAtom(con->display, HERBST_IPC_ARGS_ATOM, False);
-    con->atom_output = XInternAtom(con->display, HERBST_IPC_OUTPUT_ATOM, False);
-    con->atom_status = XInternAtom(con->display, HERBST_IPC_STATUS_ATOM, False);
+    con->socket_fd = -1;
+    // intern all atoms in a single round trip
+    char* atom_names[] = {
+        HERBST_IPC_ARGS_ATOM,
+        HERBST_IPC_OUTPUT_ATOM,
+        HERBST_IPC_STATUS_ATOM,
+        HERBST_IPC_SOCKET_ATOM,
+        HERBST_IPC_TOKEN_ATOM,
+    };
+    Atom atoms[5];
+    XInternAtoms(con->display, atom_names, 5, False, atoms);
+    con->atom_args = atoms[0];
+    con->atom_output = atoms[1];
+    con->atom_status = atoms[2];
+    con->atom_socket = atoms[3];
+    con->atom_token = atoms[4];
     return con;
 }
 
@@ -60,6 +90,9 @@ void hc_disconnect(HCConnection* con) {
     if (con->client_window) {
         XDestroyWindow(con->display, con->client_window);
     }
+    if (con->socket_fd >= 0) {
+        close(con->socket_fd);
+    }
     if (con->own_display) {
         XCloseDisplay(con->display);
     }
@@ -89,8 +122,192 @@ bool hc_create_client_window(HCConnection* con) {
     return true;
 }
 
+static bool read_all(int fd, void* buf, size_t len);
+
+// whether the server on the other end of 'fd' is the herbstluftwm instance
+// of this display, i.e. greets with the token announced on the root window
+static bool hc_socket_check_token(HCConnection* con, int fd) {
+    char* token = read_window_property(con->display, con->root, con->atom_token);
+    if (!token) {
+        return false;
+    }
+    // do not wait forever for something that does not greet at all
+    struct timeval timeout = { 2, 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    HerbstIpcHeader header;
+    bool same = read_all(fd, &header, sizeof(header))
+        && header.type == HERBST_IPC_MSG_HELLO
+        && header.length == strlen(token);
+    if (same) {
+        char* payload = malloc(header.length + 1);
+        same = payload
+            && read_all(fd, payload, header.length)
+            && memcmp(payload, token, header.length) == 0;
+        free(payload);
+    }
+    free(token);
+    timeout.tv_sec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return same;
+}
+
+bool hc_socket_connect(HCConnection* con) {
+    if (con->socket_fd >= 0) {
+        return true;
+    }
+    if (con->socket_checked) {
+        return false;
+    }
+    con->socket_checked = true;
+    char* path = read_window_property(con->display, con->root, con->atom_socket);
+    if (!path) {
+        return false;
+    }
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        free(path);
+        return false;
+    }
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    free(path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        // the socket is stale, e.g. because herbstluftwm was killed
+        close(fd);
+        return false;
+    }
+    if (!hc_socket_check_token(con, fd)) {
+        // the socket belongs to a different herbstluftwm
+        close(fd);
+        return false;
+    }
+    con->socket_fd = fd;
+    return true;
+}
+
+static bool write_all(int fd, const void* buf, size_t len) {
+    const char* pos = buf;
+    while (len > 0) {
+        ssize_t count = send(fd, pos, len, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        pos += count;
+        len -= count;
+    }
+    return true;
+}
+
+static bool read_all(int fd, void* buf, size_t len) {
+    char* pos = buf;
+    while (len > 0) {
+        ssize_t count = read(fd, pos, len);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        pos += count;
+        len -= count;
+    }
+    return true;
+}
+
+//! send a message whose payload is a list of strings via the socket
+static bool send_string_list(HCConnection* con, uint32_t type,
+                             int argc, char* argv[], uint32_t* ret_id) {
+    HerbstIpcHeader header;
+    header.type = type;
+    header.id = con->next_request_id++;
+    header.status = (type == HERBST_IPC_MSG_CALL) ? con->output_format : 0;
+    header.length = 0;
+    for (int i = 0; i < argc; i++) {
+        header.length += strlen(argv[i]) + 1;
+    }
+    if (!write_all(con->socket_fd, &header, sizeof(header))) {
+        return false;
+    }
+    for (int i = 0; i < argc; i++) {
+        // also send the terminating null character
+        if (!write_all(con->socket_fd, argv[i], strlen(argv[i]) + 1)) {
+            return false;
+        }
+    }
+    *ret_id = header.id;
+    return true;
+}
+
+bool hc_set_output_format(HCConnection* con, int format) {
+    if (format != HERBST_IPC_FORMAT_TEXT && !hc_socket_connect(con)) {
+        return false;
+    }
+    con->output_format = format;
+    return true;
+}
+
+bool hc_send_command_async(HCConnection* con, int argc, char* argv[],
+                           uint32_t* ret_id) {
+    if (!hc_socket_connect(con)) {
+        return false;
+    }
+    return send_string_list(con, HERBST_IPC_MSG_CALL, argc, argv, ret_id);
+}
+
+bool hc_next_reply(HCConnection* con, uint32_t* ret_id,
+                   char** ret_out, int* ret_status) {
+    HerbstIpcHeader header;
+    if (con->socket_fd < 0
+        || !read_all(con->socket_fd, &header, sizeof(header))
+        || header.type != HERBST_IPC_MSG_REPLY) {
+        return false;
+    }
+    char* output = malloc(header.length + 1);
+    if (!output) {
+        return false;
+    }
+    if (!read_all(con->socket_fd, output, header.length)) {
+        free(output);
+        return false;
+    }
+    output[header.length] = '\0';
+    *ret_id = header.id;
+    *ret_status = header.status;
+    *ret_out = output;
+    return true;
+}
+
+static bool hc_socket_send_command(HCConnection* con, int argc, char* argv[],
+                                   char** ret_out, int* ret_status) {
+    uint32_t id, reply_id;
+    if (!hc_send_command_async(con, argc, argv, &id)) {
+        return false;
+    }
+    if (!hc_next_reply(con, &reply_id, ret_out, ret_status)) {
+        return false;
+    }
+    if (reply_id != id) {
+        fprintf(stderr, "Error: got reply %u but expected reply %u\n",
+                (unsigned int)reply_id, (unsigned int)id);
+        free(*ret_out);
+        return false;
+    }
+    return true;
+}
+
 bool hc_send_command(HCConnection* con, int argc, char* argv[],
                      char** ret_out, int* ret_status) {
+    if (hc_socket_connect(con)) {
+        return hc_socket_send_command(con, argc, argv, ret_out, ret_status);
+    }
     if (!hc_create_client_window(con)) {
         return false;
     }
@@ -205,6 +422,9 @@ static Window get_hook_window(Display* display) {
 }
 
 bool hc_check_running(HCConnection* con) {
+    if (hc_socket_connect(con)) {
+        return true;
+    }
     return get_hook_window(con->display) != 0;
 }
 
@@ -221,7 +441,107 @@ bool hc_hook_window_connect(HCConnection* con) {
     return true;
 }
 
+bool hc_subscribe_hooks(HCConnection* con, int filterc, char* filterv[]) {
+    if (con->hooks_subscribed) {
+        return true;
+    }
+    if (!hc_socket_connect(con)) {
+        return false;
+    }
+    uint32_t id;
+    if (!send_string_list(con, HERBST_IPC_MSG_SUBSCRIBE, filterc, filterv, &id)) {
+        return false;
+    }
+    // wait for the acknowledgement, such that all hooks emitted from now on
+    // are received
+    uint32_t reply_id;
+    char* output;
+    int status;
+    if (!hc_next_reply(con, &reply_id, &output, &status)) {
+        return false;
+    }
+    free(output);
+    // herbstluftwm may reject the filter, because its regular expressions
+    // differ in details from the ones of the C library
+    con->hooks_subscribed = (status == 0);
+    return con->hooks_subscribed;
+}
+
+//! split a payload of null-terminated strings into a newly allocated argv
+static char** split_payload(char* payload, uint32_t length, int* ret_argc) {
+    int argc = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        if (payload[i] == '\0') {
+            argc++;
+        }
+    }
+    char** argv = malloc(sizeof(char*) * (argc + 1));
+    if (!argv) {
+        return NULL;
+    }
+    char* arg = payload;
+    for (int i = 0; i < argc; i++) {
+        argv[i] = strdup(arg);
+        arg += strlen(arg) + 1;
+    }
+    argv[argc] = NULL;
+    *ret_argc = argc;
+    return argv;
+}
+
+static bool hc_socket_next_hook(HCConnection* con, int* argc, char** argv[],
+                                uint32_t* ret_seq, uint32_t* ret_lost) {
+    HerbstIpcHeader header;
+    while (true) {
+        if (!read_all(con->socket_fd, &header, sizeof(header))) {
+            // herbstluftwm has quit
+            return false;
+        }
+        char* payload = malloc(header.length + 1);
+        if (!payload) {
+            return false;
+        }
+        if (!read_all(con->socket_fd, payload, header.length)) {
+            free(payload);
+            return false;
+        }
+        payload[header.length] = '\0';
+        if (header.type != HERBST_IPC_MSG_HOOK) {
+            // the loss is reported along with the next hook, which is
+            // recognized by its sequence number
+            free(payload);
+            continue;
+        }
+        *argv = split_payload(payload, header.length, argc);
+        free(payload);
+        if (!*argv) {
+            return false;
+        }
+        *ret_seq = header.id;
+        *ret_lost = header.id - con->next_hook_seq;
+        con->next_hook_seq = header.id + 1;
+        return true;
+    }
+}
+
+bool hc_next_hook_seq(HCConnection* con, int* argc, char** argv[],
+                      uint32_t* ret_seq, uint32_t* ret_lost) {
+    if (con->hooks_subscribed) {
+        return hc_socket_next_hook(con, argc, argv, ret_seq, ret_lost);
+    }
+    if (!hc_next_hook(con, argc, argv)) {
+        return false;
+    }
+    *ret_seq = con->next_hook_seq++;
+    *ret_lost = 0;
+    return true;
+}
+
 bool hc_next_hook(HCConnection* con, int* argc, char** argv[]) {
+    if (con->hooks_subscribed) {
+        uint32_t seq, lost;
+        return hc_socket_next_hook(con, argc, argv, &seq, &lost);
+    }
     if (!hc_hook_window_connect(con)) {
         return false;
     }
@@ -5,6 +5,7 @@
 
 #include <X11/Xlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifndef __HERBSTLUFT_IPC_CLIENT_H_
 #define __HERBSTLUFT_IPC_CLIENT_H_
@@ -20,6 +21,10 @@ HCConnection* hc_connect_to_display(Display* display);
 bool hc_check_running(HCConnection* con);
 void hc_disconnect(HCConnection* con);
 
+/* connect to the ipc socket of herbstluftwm; if this fails, commands are
+ * sent via X window properties */
+bool hc_socket_connect(HCConnection* con);
+
 /* ensure there is a client window for sending commands */
 bool hc_create_client_window(HCConnection* con);
 
@@ -28,8 +33,34 @@ bool hc_send_command(HCConnection* con, int argc, char* argv[],
 bool hc_send_command_once(int argc, char* argv[],
                           char** ret_out, int* ret_status);
 
+/* request the output of the following calls in the given HERBST_IPC_FORMAT_*.
+ * Formats other than plain text are only available via the ipc socket, so
+ * this returns false if the socket is not available */
+bool hc_set_output_format(HCConnection* con, int format);
+
+/* pipelined calls, only available via the ipc socket: send a call without
+ * waiting for its reply and return its request id in ret_id. The replies
+ * are then collected by hc_next_reply() */
+bool hc_send_command_async(HCConnection* con, int argc, char* argv[],
+                           uint32_t* ret_id);
+bool hc_next_reply(HCConnection* con, uint32_t* ret_id,
+                   char** ret_out, int* ret_status);
+
 bool hc_hook_window_connect(HCConnection* con);
 bool hc_next_hook(HCConnection* con, int* argc, char** argv[]);
 
+/* subscribe to the hooks via the ipc socket. Afterwards, hc_next_hook() and
+ * hc_next_hook_seq() read the hooks from the socket instead of the hook
+ * window. Only hooks are sent whose i'th argument contains a match of the
+ * extended regular expression filterv[i] (for all i < filterc). Returns
+ * false if the socket is not available or the filter is rejected */
+bool hc_subscribe_hooks(HCConnection* con, int filterc, char* filterv[]);
+/* like hc_next_hook(), but also return the hook's sequence number and the
+ * number of hooks that herbstluftwm dropped right before this one because
+ * they were not read fast enough. Without a socket subscription, the
+ * sequence number is counted locally and no loss is detected */
+bool hc_next_hook_seq(HCConnection* con, int* argc, char** argv[],
+                      uint32_t* ret_seq, uint32_t* ret_lost);
+
 #endif
 
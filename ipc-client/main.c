@@ -25,6 +25,8 @@ static int g_ensure_newline = 1; // if set, output ends with a newline
 static bool g_null_char_as_delim = false; // if true, the null character is used as delimiter
 static bool g_print_last_arg_only = false; // if true, prints only the last argument of a hook
 static int g_wait_for_hook = 0; // if set, do not execute command but wait
+static bool g_batch_mode = false; // if set, read commands from stdin
+static bool g_json_output = false; // if set, request the output as json
 static bool g_quiet = false;
 static regex_t* g_hook_regex = NULL;
 static int g_hook_regex_count = 0;
@@ -71,8 +73,9 @@ void print_help(char* command, FILE* file) {
 
     fprintf(file,
         "Usage: %s [OPTIONS] COMMAND [ARGS ...]\n"
-        "       %s [OPTIONS] [--wait|--idle] [FILTER ...]\n",
-        command, command);
+        "       %s [OPTIONS] [--wait|--idle] [FILTER ...]\n"
+        "       %s [OPTIONS] --batch\n",
+        command, command, command);
 
     char* help_string =
         "Send a COMMAND with optional arguments ARGS to a running "
@@ -81,12 +84,17 @@ void print_help(char* command, FILE* file) {
         "\t-n, --no-newline: Do not print a newline if output does not end "
             "with a newline.\n"
         "\t-0, --print0: Use the null character as delimiter between the "
-            "output of hooks.\n"
+            "output of hooks and between the commands read by --batch.\n"
         "\t-l, --last-arg: Print only the last argument of a hook.\n"
         "\t-i, --idle: Wait for hooks instead of executing commands.\n"
         "\t-w, --wait: Same as --idle but exit after first --count hooks.\n"
         "\t-c, --count COUNT: Let --wait exit after COUNT hooks were "
             "received and printed. The default of COUNT is 1.\n"
+        "\t-b, --batch: Read commands from stdin, one per line, and send "
+            "them over a single connection. For each command, print a line "
+            "with its exit status and output length, followed by the output.\n"
+        "\t-j, --json: Request the output of the commands in JSON format. "
+            "Commands without a JSON representation print plain text.\n"
         "\t-q, --quiet: Do not print error messages if herbstclient cannot "
             "connect to the running herbstluftwm instance.\n"
         "\t-v, --version: Print the herbstclient version. To get the "
@@ -118,18 +126,29 @@ int main_hook(int argc, char* argv[]) {
     signal(SIGTERM, quit_herbstclient);
     signal(SIGINT,  quit_herbstclient);
     signal(SIGQUIT, quit_herbstclient);
+    // prefer the socket, which does not lose hooks silently and lets
+    // herbstluftwm apply the filter, such that we are only woken up for
+    // matching hooks. The filter is still applied below in case the
+    // subscription fails.
+    hc_subscribe_hooks(con, argc, argv);
     int exit_code = 0;
     while (1) {
         bool print_signal = true;
         int hook_argc;
         char** hook_argv;
-        if (!hc_next_hook(con, &hook_argc, &hook_argv)) {
+        uint32_t hook_seq, hook_lost;
+        if (!hc_next_hook_seq(con, &hook_argc, &hook_argv,
+                              &hook_seq, &hook_lost)) {
             fprintf(stderr, "Cannot listen for hooks\n");
             exit_code = EXIT_FAILURE;
             // clean up HCConnection and regexes before
             // returning
             break;
         }
+        if (hook_lost > 0 && !g_quiet) {
+            fprintf(stderr, "Warning: %u hooks were dropped because they "
+                    "were not read fast enough\n", (unsigned int)hook_lost);
+        }
         for (int i = 0; i < argc && i < hook_argc; i++) {
             if (0 != regexec(g_hook_regex + i, hook_argv[i], 0, NULL, 0)) {
                 // found an regex that did not match
@@ -173,6 +192,171 @@ int main_hook(int argc, char* argv[]) {
     return exit_code;
 }
 
+//! request json output if --json is given
+static bool request_output_format(HCConnection* con) {
+    if (!g_json_output) {
+        return true;
+    }
+    if (!hc_set_output_format(con, HERBST_IPC_FORMAT_JSON)) {
+        fprintf(stderr, "Error: --json is only available via the ipc socket.\n");
+        return false;
+    }
+    return true;
+}
+
+// maximum number of calls in --batch mode that are sent but not answered yet
+#define BATCH_MAX_IN_FLIGHT 64
+
+// a command of --batch mode whose result is not printed yet
+typedef struct {
+    uint32_t id; // request id if sent via hc_send_command_async()
+    bool done; // whether status and output are known
+    int status;
+    char* output;
+} BatchCall;
+
+// receive one reply and store it in the matching pending call
+static bool batch_receive(HCConnection* con, BatchCall* calls,
+                          int head, int count) {
+    uint32_t id;
+    char* output;
+    int status;
+    if (!hc_next_reply(con, &id, &output, &status)) {
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        BatchCall* call = calls + (head + i) % BATCH_MAX_IN_FLIGHT;
+        if (!call->done && call->id == id) {
+            call->done = true;
+            call->status = status;
+            call->output = output;
+            return true;
+        }
+    }
+    fprintf(stderr, "Error: got reply to unknown request %u\n", (unsigned int)id);
+    free(output);
+    return false;
+}
+
+// print the results of the finished calls at the head of the ring buffer
+static void batch_print_done(BatchCall* calls, int* head, int* count,
+                             int* exit_code) {
+    while (*count > 0 && calls[*head].done) {
+        BatchCall* call = calls + *head;
+        size_t output_len = strlen(call->output);
+        printf("%d %zu\n", call->status, output_len);
+        fwrite(call->output, 1, output_len, stdout);
+        free(call->output);
+        if (call->status != 0) {
+            *exit_code = call->status;
+        }
+        *head = (*head + 1) % BATCH_MAX_IN_FLIGHT;
+        (*count)--;
+    }
+    fflush(stdout);
+}
+
+int main_batch() {
+    HCConnection* con = hc_connect();
+    if (!con) {
+        if (!g_quiet) {
+            fprintf(stderr, "Error: Cannot open display.\n");
+        }
+        return EXIT_FAILURE;
+    }
+    if (!hc_check_running(con)) {
+        if (!g_quiet) {
+            fprintf(stderr, "Error: herbstluftwm is not running.\n");
+        }
+        hc_disconnect(con);
+        return EXIT_FAILURE;
+    }
+    if (!request_output_format(con)) {
+        hc_disconnect(con);
+        return EXIT_FAILURE;
+    }
+    // over the socket, the commands are pipelined. Otherwise, every command
+    // is answered before the next one is sent.
+    bool pipelined = hc_socket_connect(con);
+    // stdin is not read via stdio, which would hide buffered lines from
+    // line_reader_ready()
+    LineReader input;
+    line_reader_init(&input, fileno(stdin), g_null_char_as_delim ? '\0' : '\n');
+    int exit_code = 0;
+    bool comm_error = false;
+    // ring buffer of the commands whose results are not printed yet
+    BatchCall calls[BATCH_MAX_IN_FLIGHT];
+    int head = 0;
+    int count = 0;
+    while (!comm_error) {
+        // wait for replies if no further call can be sent right now. This
+        // also prints the results immediately if the input comes in slowly.
+        while (count > 0 && !calls[head].done
+               && (count == BATCH_MAX_IN_FLIGHT || !line_reader_ready(&input)))
+        {
+            if (!batch_receive(con, calls, head, count)) {
+                comm_error = true;
+                break;
+            }
+            batch_print_done(calls, &head, &count, &exit_code);
+        }
+        if (comm_error) {
+            break;
+        }
+        char* line = line_reader_next(&input);
+        if (!line) {
+            break;
+        }
+        int cmd_argc = 0;
+        char** cmd_argv = NULL;
+        BatchCall* call = calls + (head + count) % BATCH_MAX_IN_FLIGHT;
+        if (!split_command(line, &cmd_argc, &cmd_argv)) {
+            // still report the error such that the output stays in sync
+            // with the input
+            call->done = true;
+            call->status = HERBST_INVALID_ARGUMENT;
+            call->output = strdup("herbstclient: unterminated quote\n");
+            count++;
+        } else if (cmd_argc == 0) {
+            // skip empty lines
+        } else if (pipelined) {
+            call->done = false;
+            comm_error = !hc_send_command_async(con, cmd_argc, cmd_argv, &call->id);
+            count++;
+        } else {
+            comm_error = !hc_send_command(con, cmd_argc, cmd_argv,
+                                          &call->output, &call->status);
+            call->done = !comm_error;
+            count++;
+        }
+        argv_free(cmd_argc, cmd_argv);
+        free(line);
+        if (!comm_error) {
+            batch_print_done(calls, &head, &count, &exit_code);
+        }
+    }
+    // collect the remaining replies
+    while (!comm_error && count > 0) {
+        if (!batch_receive(con, calls, head, count)) {
+            comm_error = true;
+            break;
+        }
+        batch_print_done(calls, &head, &count, &exit_code);
+    }
+    if (comm_error) {
+        fprintf(stderr, "Error: Could not send command.\n");
+        exit_code = EXIT_FAILURE;
+        for (int i = 0; i < count; i++) {
+            BatchCall* call = calls + (head + i) % BATCH_MAX_IN_FLIGHT;
+            if (call->done) {
+                free(call->output);
+            }
+        }
+    }
+    hc_disconnect(con);
+    return exit_code;
+}
+
 int main(int argc, char* argv[]) {
     static struct option long_options[] = {
         {"no-newline", 0, 0, 'n'},
@@ -181,6 +365,8 @@ int main(int argc, char* argv[]) {
         {"wait", 0, 0, 'w'},
         {"count", 1, 0, 'c'},
         {"idle", 0, 0, 'i'},
+        {"batch", 0, 0, 'b'},
+        {"json", 0, 0, 'j'},
         {"quiet", 0, 0, 'q'},
         {"version", 0, 0, 'v'},
         {"help", 0, 0, 'h'},
@@ -189,7 +375,7 @@ int main(int argc, char* argv[]) {
     // parse options
     while (1) {
         int option_index = 0;
-        int c = getopt_long(argc, argv, "+n0lwc:iqhv", long_options, &option_index);
+        int c = getopt_long(argc, argv, "+n0lwc:ibjqhv", long_options, &option_index);
         if (c == -1) break;
         switch (c) {
             case 'i':
@@ -202,6 +388,12 @@ int main(int argc, char* argv[]) {
             case 'w':
                 g_wait_for_hook = 1;
                 break;
+            case 'b':
+                g_batch_mode = true;
+                break;
+            case 'j':
+                g_json_output = true;
+                break;
             case 'n':
                 g_ensure_newline = 0;
                 break;
@@ -225,6 +417,13 @@ int main(int argc, char* argv[]) {
         }
     }
     int arg_index = optind; // index of the first-non-option argument
+    if (g_batch_mode) {
+        if (argc - arg_index != 0 || g_wait_for_hook) {
+            print_help(argv[0], stderr);
+            exit(EXIT_FAILURE);
+        }
+        return main_batch();
+    }
     if ((argc - arg_index == 0) && !g_wait_for_hook) {
         // if there are no non-option arguments, and no --idle/--wait, display
         // the help and exit
@@ -248,6 +447,10 @@ int main(int argc, char* argv[]) {
             hc_disconnect(con);
             return EXIT_FAILURE;
         }
+        if (!request_output_format(con)) {
+            hc_disconnect(con);
+            return EXIT_FAILURE;
+        }
         bool suc = hc_send_command(con, argc-arg_index, argv+arg_index,
                                    &output, &command_status);
         hc_disconnect(con);
@@ -10,9 +10,30 @@ hc() { "${herbstclient_command[@]:-herbstclient}" "$@" ;}
 # and sometime later:
 # loadstate.sh < mystate
 
+# prints the argument in single quotes, as understood by hc --batch
+quote() {
+    local squote="'"
+    printf "'%s'" "${1//$squote/$squote\\$squote$squote}"
+}
+
+# prints the output of the failing commands of hc --batch to stderr
+report_failures() {
+    local LC_ALL=C # the lengths are given in bytes
+    local status length output
+    while read -r status length ; do
+        output=''
+        if (( length > 0 )) ; then
+            IFS= read -r -N "$length" output
+        fi
+        if [[ "$status" != 0 ]] ; then
+            printf '%s' "$output" >&2
+        fi
+    done
+}
+
 while read line ; do
     tag="${line%%: *}"
     tree="${line#*: }"
-    hc add "$tag"
-    hc load "$tag" "$tree"
-done
+    printf 'add %s\nload %s %s\n' "$(quote "$tag")" "$(quote "$tag")" "$(quote "$tree")"
+done | hc --batch | report_failures
+exit "${PIPESTATUS[1]}"
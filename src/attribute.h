@@ -62,6 +62,8 @@ public:
     virtual Signal& changed() = 0;
 
     virtual std::string str() { return {}; }
+    //! append str() to the buffer without creating a temporary string
+    virtual void appendStr(std::string& buffer) { buffer += str(); }
     virtual std::string change(const std::string &payload) = 0;
     //! suggestions for a new value of the attribute
     virtual void complete(Completion& complete) = 0;
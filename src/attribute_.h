@@ -109,6 +109,9 @@ public:
 
     // wrap Converter::str() for convenience
     std::string str() override { return Converter<T>::str(payload_); }
+    void appendStr(std::string& buffer) override {
+        Converter<T>::append(buffer, payload_);
+    }
 
     void complete(Completion& complete) override {
         Converter<T>::complete(complete, &payload_);
@@ -273,6 +276,9 @@ public:
     std::string str() override {
         return Converter<T>::str(getter_());
     }
+    void appendStr(std::string& buffer) override {
+        Converter<T>::append(buffer, getter_());
+    }
 
     std::string change(const std::string &payload_str) override {
         if (!writeable()) return "attribute is read-only";
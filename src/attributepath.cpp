@@ -0,0 +1,55 @@
+#include "attributepath.h"
+
+#include <sstream>
+
+#include "arglist.h"
+#include "object.h"
+
+using std::endl;
+using std::string;
+
+AttributePath::AttributePath(Object* root, const string& path)
+    : root_(root)
+    , path_(path)
+{
+    auto split = Object::splitPath(path);
+    objectPath_ = split.first.toVector();
+    attributeName_ = split.second;
+}
+
+Attribute* AttributePath::resolve() {
+    std::ostringstream output;
+    return resolve(output);
+}
+
+Attribute* AttributePath::resolve(Output output) {
+    if (attribute_ && generation_ == Object::treeGeneration()) {
+        return attribute_;
+    }
+    attribute_ = nullptr;
+    Object* owner = root_;
+    for (const auto& name : objectPath_) {
+        owner = owner->child(name);
+        if (!owner) {
+            output << "No such object " << ArgList(objectPath_).join('.') << endl;
+            return nullptr;
+        }
+    }
+    Attribute* a = owner->attribute(attributeName_);
+    if (!a) {
+        auto object_path = ArgList(objectPath_).join('.');
+        if (object_path.empty()) {
+            object_path = "The root object";
+        } else {
+            // equip object_path with quotes
+            object_path = "Object \"" + object_path + "\"";
+        }
+        output << object_path
+               << " has no attribute \"" << attributeName_ << "\""
+               << endl;
+        return nullptr;
+    }
+    attribute_ = a;
+    generation_ = Object::treeGeneration();
+    return a;
+}
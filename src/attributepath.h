@@ -0,0 +1,36 @@
+#ifndef HERBSTLUFT_ATTRIBUTEPATH_H
+#define HERBSTLUFT_ATTRIBUTEPATH_H
+
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+class Attribute;
+class Object;
+
+/** A path to an attribute in the object tree, e.g. "tags.focus.name", that
+ * is parsed only once. The attribute it points to is looked up on the first
+ * access and then remembered until children or attributes are added to or
+ * removed from any object in the tree (see Object::treeGeneration()).
+ */
+class AttributePath {
+public:
+    AttributePath(Object* root, const std::string& path);
+
+    //! return the attribute or nullptr if the path does not resolve;
+    //! in the latter case, an error message is printed to output
+    Attribute* resolve(Output output);
+    Attribute* resolve();
+
+    const std::string& str() const { return path_; }
+private:
+    Object* root_;
+    std::string path_;
+    std::vector<std::string> objectPath_;
+    std::string attributeName_;
+    Attribute* attribute_ = nullptr;
+    unsigned long generation_ = 0;
+};
+
+#endif
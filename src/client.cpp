@@ -234,15 +234,15 @@ void Client::setup_border(bool focused) {
     dec->change_scheme(getDecTriple()(focused, urgent_()));
 }
 
-void Client::resize_fullscreen(Rectangle monitor_rect, bool isFocused) {
-    dec->resize_outline(monitor_rect, theme[Theme::Type::Fullscreen](isFocused,urgent_()));
+bool Client::resize_fullscreen(Rectangle monitor_rect, bool isFocused) {
+    return dec->resize_outline(monitor_rect, theme[Theme::Type::Fullscreen](isFocused,urgent_()));
 }
 
 void Client::raise() {
     this->tag()->stack->raiseSlice(this->slice);
 }
 
-void Client::resize_tiling(Rectangle rect, bool isFocused) {
+bool Client::resize_tiling(Rectangle rect, bool isFocused) {
     auto& scheme = theme[Theme::Type::Tiling](isFocused, urgent_());
     if (this->pseudotile_) {
         auto inner = this->float_size_;
@@ -253,7 +253,7 @@ void Client::resize_tiling(Rectangle rect, bool isFocused) {
         rect.width = std::min(outline.width, rect.width);
         rect.height = std::min(outline.height, rect.height);
     }
-    dec->resize_outline(rect, scheme);
+    return dec->resize_outline(rect, scheme);
 }
 
 // from dwm.c
@@ -382,8 +382,8 @@ void Client::send_configure() {
     XSendEvent(g_display, this->window_, False, StructureNotifyMask, (XEvent *)&ce);
 }
 
-void Client::resize_floating(Monitor* m, bool isFocused) {
-    if (!m) return;
+bool Client::resize_floating(Monitor* m, bool isFocused) {
+    if (!m) return false;
     auto rect = this->float_size_;
     rect.x += m->rect.x;
     rect.y += m->rect.y;
@@ -399,7 +399,7 @@ void Client::resize_floating(Monitor* m, bool isFocused) {
         CLAMP(rect.y,
               m->rect.y + m->pad_up() - rect.height + space,
               m->rect.y + m->rect.height - m->pad_up() - m->pad_down() - space);
-    dec->resize_inner(rect, theme[Theme::Type::Floating](isFocused,urgent_()));
+    return dec->resize_inner(rect, theme[Theme::Type::Floating](isFocused,urgent_()));
 }
 
 Rectangle Client::outer_floating_rect() {
@@ -3,6 +3,7 @@
 
 #include <X11/X.h>
 #include <X11/Xlib.h>
+#include <memory>
 
 #include "attribute_.h"
 #include "object.h"
@@ -13,6 +14,7 @@
 class Decoration;
 class DecTriple;
 class Ewmh;
+class HSFrameLeaf;
 class Slice;
 class HSTag;
 class Monitor;
@@ -31,6 +33,10 @@ public:
     Rectangle   float_size_ = {0, 0, 100, 100};     // floating size without the window border
     HSTag*      tag_ = {};
     Slice* slice = {};
+    // the frame containing this client and the client's index in there.
+    // This is maintained by HSFrameLeaf.
+    std::weak_ptr<HSFrameLeaf> frameLeaf_;
+    size_t      frameLeafIndex_ = 0;
     bool        ewmhfullscreen_ = false; // ewmh fullscreen state
     bool        neverfocus_ = false; // do not give the focus via XSetInputFocus
     bool        visible_;
@@ -87,9 +93,10 @@ public:
     Rectangle outer_floating_rect();
 
     void setup_border(bool focused);
-    void resize_tiling(Rectangle rect, bool isFocused);
-    void resize_floating(Monitor* m, bool isFocused);
-    void resize_fullscreen(Rectangle m, bool isFocused);
+    // the resize functions return whether the windows had to be updated
+    bool resize_tiling(Rectangle rect, bool isFocused);
+    bool resize_floating(Monitor* m, bool isFocused);
+    bool resize_fullscreen(Rectangle m, bool isFocused);
     bool is_client_floated();
     bool needs_minimal_dec();
     void set_urgent(bool state);
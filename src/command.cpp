@@ -508,9 +508,15 @@ int complete_against_commands(int argc, char** argv, int position,
     // complete command
     if (position == 0) {
         char* str = (argc >= 1) ? argv[0] : nullptr;
-        for (auto cmd : *Commands::get()) {
-            // only check the first len bytes
-            try_complete(str, cmd.first.c_str(), output);
+        string needle = str ? str : "";
+        auto commandTable = Commands::get();
+        const auto& names = commandTable->names();
+        // the names starting with the needle form a contiguous range
+        for (auto it = names.lower_bound(needle);
+             it != names.end() && Completion::prefixOf(needle, *it);
+             it++)
+        {
+            try_complete(str, it->c_str(), output);
         }
         return 0;
     }
@@ -2,6 +2,7 @@
 #define __HERBSTLUFT_COMMAND_H_
 
 #include <functional>
+#include <set>
 #include <string>
 #include <unordered_map>
 
@@ -121,15 +122,23 @@ class CommandTable {
 
 public:
     CommandTable(std::initializer_list<Container::value_type> values)
-        : map(values) {}
+        : map(values)
+    {
+        for (const auto& it : map) {
+            names_.insert(it.first);
+        }
+    }
 
     int callCommand(Input args, Output out) const;
+    //! the command names in sorted order, for completing a name prefix
+    const std::set<std::string>& names() const { return names_; }
 
     Container::const_iterator begin() const { return map.cbegin(); }
     Container::const_iterator end() const { return map.cend(); }
     Container::const_iterator find(const std::string& str) const { return map.find(str); }
 private:
     Container map;
+    std::set<std::string> names_;
 };
 
 namespace Commands {
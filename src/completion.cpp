@@ -65,8 +65,8 @@ bool Completion::noParameterExpected() const {
 
 bool Completion::prefixOf(const string& shorter, const string& longer)
 {
-    auto res = std::mismatch(shorter.begin(), shorter.end(), longer.begin());
-    return res.first == shorter.end();
+    return shorter.size() <= longer.size()
+        && longer.compare(0, shorter.size(), shorter) == 0;
 }
 
 void Completion::partial(const string& word) {
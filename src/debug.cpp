@@ -0,0 +1,140 @@
+#include "debug.h"
+
+#include <X11/X.h>
+#include <algorithm>
+#include <sstream>
+
+using std::string;
+using std::unique_ptr;
+
+MainLoopStats::MainLoopStats()
+    : iterations_(this, "iterations", [this]() { return iterations; })
+    , events_(this, "events", [this]() { return events; })
+    , roundtrips_(this, "roundtrips", [this]() { return roundtrips; })
+    , roundtripsSaved_(this, "roundtrips_saved", [this]() { return roundtripsSaved; })
+{
+}
+
+EventCoalescing::EventCoalescing()
+    : motion(this, "motion", true, [](bool) { return ""; })
+    , property(this, "property", true, [](bool) { return ""; })
+    , configureRequest(this, "configure_request", true, [](bool) { return ""; })
+    , enter(this, "enter", true, [](bool) { return ""; })
+    , motionMerged_(this, "motion_merged", [this]() { return motionMerged; })
+    , propertyMerged_(this, "property_merged", [this]() { return propertyMerged; })
+    , configureRequestMerged_(this, "configure_request_merged",
+                              [this]() { return configureRequestMerged; })
+    , enterMerged_(this, "enter_merged", [this]() { return enterMerged; })
+{
+}
+
+LayoutStats::LayoutStats()
+    : defer(this, "defer", true, [](bool) { return ""; })
+    , requested_(this, "requested", [this]() { return requested; })
+    , executed_(this, "executed", [this]() { return executed; })
+    , windowsConfigured_(this, "windows_configured", [this]() { return windowsConfigured; })
+    , windowsUnchanged_(this, "windows_unchanged", [this]() { return windowsUnchanged; })
+    , bufferGrowths_(this, "buffer_growths", [this]() { return bufferGrowths; })
+{
+}
+
+QueryCacheStats::QueryCacheStats()
+    : enabled(this, "cache", true, [](bool) { return ""; })
+    , hits_(this, "hits", [this]() { return hits; })
+    , misses_(this, "misses", [this]() { return misses; })
+{
+}
+
+EventHandlerStats::EventHandlerStats()
+    : calls_(this, "calls", [this]() { return calls; })
+    , totalTime_(this, "total_us", [this]() { return totalTime; })
+    , maxTime_(this, "max_us", [this]() { return maxTime; })
+    , histogram_(this, "histogram", &EventHandlerStats::histogramString)
+{
+}
+
+void EventHandlerStats::record(unsigned long microseconds) {
+    calls++;
+    totalTime += microseconds;
+    maxTime = std::max(maxTime, microseconds);
+    size_t bucket = 0;
+    while (microseconds >= 2 && bucket + 1 < bucketCount) {
+        microseconds /= 2;
+        bucket++;
+    }
+    histogram[bucket]++;
+}
+
+void EventHandlerStats::reset() {
+    calls = 0;
+    totalTime = 0;
+    maxTime = 0;
+    histogram.fill(0);
+}
+
+//! the buckets up to the last non-empty one, separated by spaces
+string EventHandlerStats::histogramString() {
+    size_t used = bucketCount;
+    while (used > 0 && histogram[used - 1] == 0) {
+        used--;
+    }
+    std::stringstream output;
+    for (size_t i = 0; i < used; i++) {
+        output << (i ? " " : "") << histogram[i];
+    }
+    return output.str();
+}
+
+//! the names of the core X events, indexed by their type
+static const char* eventNames[LASTEvent] = {
+    nullptr, nullptr, "KeyPress", "KeyRelease", "ButtonPress",
+    "ButtonRelease", "MotionNotify", "EnterNotify", "LeaveNotify", "FocusIn",
+    "FocusOut", "KeymapNotify", "Expose", "GraphicsExpose", "NoExpose",
+    "VisibilityNotify", "CreateNotify", "DestroyNotify", "UnmapNotify",
+    "MapNotify", "MapRequest", "ReparentNotify", "ConfigureNotify",
+    "ConfigureRequest", "GravityNotify", "ResizeRequest", "CirculateNotify",
+    "CirculateRequest", "PropertyNotify", "SelectionClear",
+    "SelectionRequest", "SelectionNotify", "ColormapNotify", "ClientMessage",
+    "MappingNotify", "GenericEvent",
+};
+
+EventStats::EventStats()
+    : enabled(this, "enabled", false, [](bool) { return ""; })
+    , reset_(this, "reset", &EventStats::resetGetterHelper,
+                            &EventStats::resetSetterHelper)
+{
+    for (int type = 0; type < LASTEvent; type++) {
+        if (!eventNames[type]) {
+            continue;
+        }
+        handlers_[type] = unique_ptr<EventHandlerStats>(new EventHandlerStats());
+        addStaticChild(handlers_[type].get(), eventNames[type]);
+    }
+}
+
+void EventStats::record(int eventType, unsigned long microseconds) {
+    auto it = handlers_.find(eventType);
+    if (it != handlers_.end()) {
+        it->second->record(microseconds);
+    }
+}
+
+string EventStats::resetGetterHelper() {
+    return "Writing this resets all event statistics";
+}
+
+string EventStats::resetSetterHelper(string) {
+    for (auto& it : handlers_) {
+        it.second->reset();
+    }
+    return {};
+}
+
+Debug::Debug()
+{
+    addStaticChild(&mainloop, "mainloop");
+    addStaticChild(&coalescing, "coalescing");
+    addStaticChild(&layout, "layout");
+    addStaticChild(&queries, "queries");
+    addStaticChild(&events, "events");
+}
@@ -0,0 +1,140 @@
+#ifndef __HERBSTLUFT_DEBUG_H_
+#define __HERBSTLUFT_DEBUG_H_
+
+#include <array>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "attribute_.h"
+#include "object.h"
+
+//! counters of the main loop
+class MainLoopStats : public Object {
+public:
+    MainLoopStats();
+    unsigned long iterations = 0; //! how often the main loop waited for input
+    unsigned long events = 0; //! how many X events were dispatched
+    unsigned long roundtrips = 0; //! how often the main loop called XSync()
+    //! how often the main loop skipped the XSync() that it formerly did
+    //! after waking up and after every event
+    unsigned long roundtripsSaved = 0;
+private:
+    DynAttribute_<unsigned long> iterations_;
+    DynAttribute_<unsigned long> events_;
+    DynAttribute_<unsigned long> roundtrips_;
+    DynAttribute_<unsigned long> roundtripsSaved_;
+};
+
+/** Rules for dropping X events that are superseded by an event that is
+ * already queued, and counters for how many events have been dropped
+ */
+class EventCoalescing : public Object {
+public:
+    EventCoalescing();
+    // the rules, each of them can be disabled
+    Attribute_<bool> motion;
+    Attribute_<bool> property;
+    Attribute_<bool> configureRequest;
+    Attribute_<bool> enter;
+    // the counters
+    unsigned long motionMerged = 0;
+    unsigned long propertyMerged = 0;
+    unsigned long configureRequestMerged = 0;
+    unsigned long enterMerged = 0;
+private:
+    DynAttribute_<unsigned long> motionMerged_;
+    DynAttribute_<unsigned long> propertyMerged_;
+    DynAttribute_<unsigned long> configureRequestMerged_;
+    DynAttribute_<unsigned long> enterMerged_;
+};
+
+/** Relayouts requested by signals (e.g. attribute changes) are collected and
+ * applied once per main loop iteration. This object counts how many
+ * relayouts were requested and how many were actually computed.
+ */
+class LayoutStats : public Object {
+public:
+    LayoutStats();
+    Attribute_<bool> defer; //! whether requested relayouts may be postponed
+    unsigned long requested = 0;
+    unsigned long executed = 0;
+    //! clients whose windows had to be moved, resized or redrawn by a relayout
+    unsigned long windowsConfigured = 0;
+    //! clients that already had the geometry and decoration of a relayout
+    unsigned long windowsUnchanged = 0;
+    //! how often a buffer for layout results had to be enlarged
+    unsigned long bufferGrowths = 0;
+private:
+    DynAttribute_<unsigned long> requested_;
+    DynAttribute_<unsigned long> executed_;
+    DynAttribute_<unsigned long> windowsConfigured_;
+    DynAttribute_<unsigned long> windowsUnchanged_;
+    DynAttribute_<unsigned long> bufferGrowths_;
+};
+
+/** Replies to read-only queries (e.g. tag_status or get_attr of a path
+ * outside of 'debug') are kept until the next X event or state changing
+ * command, such that a query repeated in between is answered without
+ * evaluating it again. Queries that may cover the debug counters, such
+ * as snapshot or object_tree of the entire tree, are never kept.
+ */
+class QueryCacheStats : public Object {
+public:
+    QueryCacheStats();
+    Attribute_<bool> enabled; //! whether query replies may be reused
+    unsigned long hits = 0;
+    unsigned long misses = 0;
+private:
+    DynAttribute_<unsigned long> hits_;
+    DynAttribute_<unsigned long> misses_;
+};
+
+/** How long the handler for one type of X event took, with a histogram
+ * of the durations. Bucket i counts the calls that took between 2^i and
+ * 2^(i+1) microseconds (bucket 0 also counts the faster ones).
+ */
+class EventHandlerStats : public Object {
+public:
+    EventHandlerStats();
+    static const size_t bucketCount = 24;
+    void record(unsigned long microseconds);
+    void reset();
+    unsigned long calls = 0;
+    unsigned long totalTime = 0; //! in microseconds
+    unsigned long maxTime = 0; //! in microseconds
+    std::array<unsigned long, bucketCount> histogram = {};
+private:
+    std::string histogramString();
+    DynAttribute_<unsigned long> calls_;
+    DynAttribute_<unsigned long> totalTime_;
+    DynAttribute_<unsigned long> maxTime_;
+    DynAttribute_<std::string> histogram_;
+};
+
+//! the time spent in the X event handlers, per event type
+class EventStats : public Object {
+public:
+    EventStats();
+    Attribute_<bool> enabled; //! whether the handlers are timed at all
+    //! record that the handler for the given event type took that long
+    void record(int eventType, unsigned long microseconds);
+private:
+    std::string resetGetterHelper();
+    std::string resetSetterHelper(std::string dummy);
+    DynAttribute_<std::string> reset_;
+    std::map<int, std::unique_ptr<EventHandlerStats>> handlers_;
+};
+
+//! the 'debug' object holding statistics about herbstluftwm's internals
+class Debug : public Object {
+public:
+    Debug();
+    MainLoopStats mainloop;
+    EventCoalescing coalescing;
+    LayoutStats layout;
+    QueryCacheStats queries;
+    EventStats events;
+};
+
+#endif
@@ -132,16 +132,17 @@ Rectangle DecorationScheme::inner_rect_to_outline(Rectangle rect) const {
             .adjusted(*padding_left, *padding_top, *padding_right, *padding_bottom);
 }
 
-void Decoration::resize_inner(Rectangle inner, const DecorationScheme& scheme) {
-    resize_outline(scheme.inner_rect_to_outline(inner), scheme);
+bool Decoration::resize_inner(Rectangle inner, const DecorationScheme& scheme) {
+    bool updated = resize_outline(scheme.inner_rect_to_outline(inner), scheme);
     last_rect_inner = true;
+    return updated;
 }
 
 Rectangle Decoration::inner_to_outer(Rectangle rect) {
     return last_scheme->inner_rect_to_outline(rect);
 }
 
-void Decoration::resize_outline(Rectangle outline, const DecorationScheme& scheme)
+bool Decoration::resize_outline(Rectangle outline, const DecorationScheme& scheme)
 {
     auto inner = scheme.outline_to_inner_rect(outline);
     Window win = client_->window_;
@@ -167,6 +168,12 @@ void Decoration::resize_outline(Rectangle outline, const DecorationScheme& schem
     if (false) { // formely: if (tight_decoration)
         outline = scheme.inner_rect_to_outline(inner);
     }
+    if (unchanged(outline, inner, scheme)) {
+        // the windows already look like this, so all X requests below
+        // would be no-ops
+        last_rect_inner = false;
+        return false;
+    }
     last_inner_rect = inner;
     inner.x -= outline.x;
     inner.y -= outline.y;
@@ -196,6 +203,7 @@ void Decoration::resize_outline(Rectangle outline, const DecorationScheme& schem
     last_rect_inner = false;
     client_->last_size_ = inner;
     last_scheme = &scheme;
+    last_scheme_generation = scheme.generation();
     // redraw
     // TODO: reduce flickering
     if (!client_->dragged_ || settings_.update_dragged_clients()) {
@@ -222,7 +230,31 @@ void Decoration::resize_outline(Rectangle outline, const DecorationScheme& schem
     if (!client_->dragged_ || settings_.update_dragged_clients()) {
         client_->send_configure();
     }
-    XSync(g_display, False);
+    // no XSync() here: relayouts do one round trip after all monitors have
+    // been arranged, and otherwise the main loop flushes the requests
+    return true;
+}
+
+/** whether resizing to the given outline and (absolute) inner rectangle
+ * with the given scheme would leave all windows as they are
+ */
+bool Decoration::unchanged(Rectangle outline, Rectangle inner,
+                           const DecorationScheme& scheme) const
+{
+    if (!last_scheme || last_scheme != &scheme
+        || last_scheme_generation != scheme.generation())
+    {
+        // never drawn or the colors or borders may have changed
+        return false;
+    }
+    Rectangle actual = inner;
+    actual.x -= outline.x;
+    actual.y -= outline.y;
+    // if the last_actual_rect differs, the client has not been updated
+    // while being dragged
+    return outline == last_outer_rect
+        && inner == last_inner_rect
+        && actual == last_actual_rect;
 }
 
 void Decoration::updateFrameExtends() {
@@ -15,11 +15,12 @@ public:
     Decoration(Client* client_, Settings& settings_);
     void createWindow();
     virtual ~Decoration();
-    // resize such that the decorated outline of the window fits into rect
-    void resize_outline(Rectangle rect, const DecorationScheme& scheme);
+    // resize such that the decorated outline of the window fits into rect.
+    // Returns false if nothing had to be changed.
+    bool resize_outline(Rectangle rect, const DecorationScheme& scheme);
 
     // resize such that the window content fits into rect
-    void resize_inner(Rectangle rect, const DecorationScheme& scheme);
+    bool resize_inner(Rectangle rect, const DecorationScheme& scheme);
     void change_scheme(const DecorationScheme& scheme);
 
     static Client* toClient(Window decoration_window);
@@ -31,11 +32,14 @@ public:
 
 private:
     void redrawPixmap();
+    bool unchanged(Rectangle outline, Rectangle inner,
+                   const DecorationScheme& scheme) const;
     void updateFrameExtends();
     unsigned int get_client_color(Color color);
 
     Window                  decwin = 0; // the decoration window
     const DecorationScheme* last_scheme = {};
+    unsigned long           last_scheme_generation = 0;
     bool                    last_rect_inner = false; // whether last_rect is inner size
     Rectangle   last_inner_rect = {0, 0, 0, 0}; // only valid if width >= 0
     Rectangle   last_outer_rect = {0, 0, 0, 0}; // only valid if width >= 0
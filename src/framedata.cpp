@@ -39,6 +39,11 @@ template<> string Converter<LayoutAlgorithm>::str(LayoutAlgorithm payload) {
     return g_layout_names[(int) payload];
 }
 
+template<> void Converter<LayoutAlgorithm>::append(string& buffer,
+                                                   const LayoutAlgorithm& payload) {
+    buffer += g_layout_names[(int) payload];
+}
+
 template<> void Converter<LayoutAlgorithm>::complete(Completion& complete, LayoutAlgorithm const* relativeTo) {
     for (size_t i = 0; g_layout_names[i] != nullptr; i++) {
         complete.full(g_layout_names[i]);
@@ -58,6 +63,11 @@ template<> string Converter<SplitAlign>::str(SplitAlign payload) {
     return g_align_names[(int) payload];
 }
 
+template<> void Converter<SplitAlign>::append(string& buffer,
+                                              const SplitAlign& payload) {
+    buffer += g_align_names[(int) payload];
+}
+
 template<> void Converter<SplitAlign>::complete(Completion& complete, SplitAlign const* relativeTo) {
     for (size_t i = 0; g_align_names[i] != nullptr; i++) {
         complete.full(g_align_names[i]);
@@ -10,6 +10,7 @@
 #include "ipc-protocol.h"
 #include "layout.h"
 #include "monitor.h"
+#include "outputformat.h"
 #include "stack.h"
 #include "tag.h"
 #include "tagmanager.h"
@@ -65,6 +66,36 @@ void FrameTree::dump(shared_ptr<HSFrame> frame, Output output)
     }
 }
 
+//! the frame and its subframes as nested json objects
+void FrameTree::dumpJson(shared_ptr<HSFrame> frame, shared_ptr<HSFrameLeaf> focus,
+                         JsonWriter& json)
+{
+    json.beginObject();
+    auto l = frame->isLeaf();
+    if (l) {
+        json.key("type").value("clients");
+        json.key("layout").value(Converter<LayoutAlgorithm>::str(l->layout));
+        json.key("selection").value(l->selection);
+        json.key("focused").value(l == focus);
+        json.key("clients").beginArray();
+        for (auto client : l->clients) {
+            json.value(WindowID(client->x11Window()).str());
+        }
+        json.endArray();
+    }
+    auto s = frame->isSplit();
+    if (s) {
+        json.key("type").value("split");
+        json.key("align").value(Converter<SplitAlign>::str(s->align_));
+        json.key("fraction").value(((double)s->fraction_) / (double)FRACTION_UNIT);
+        json.key("selection").value(s->selection_);
+        json.key("children").beginArray();
+        FrameTree::dumpJson(s->a_, focus, json);
+        FrameTree::dumpJson(s->b_, focus, json);
+        json.endArray();
+    }
+    json.endObject();
+}
 
 /*! look up a specific frame in the frame tree
  */
@@ -230,6 +261,7 @@ int FrameTree::rotateCommand() {
                     s->fraction_ = FRACTION_UNIT - s->fraction_;
                     break;
             }
+            s->invalidateLayout();
         };
     void (*onLeaf)(HSFrameLeaf*) =
         [] (HSFrameLeaf*) {
@@ -303,16 +335,7 @@ void FrameTree::prettyPrint(shared_ptr<HSFrame> frame, Output output) {
 }
 
 shared_ptr<HSFrameLeaf> FrameTree::findFrameWithClient(Client* client) {
-    shared_ptr<HSFrameLeaf> frame = {};
-    root_->fmap(
-        [](HSFrameSplit*) {},
-        [&](HSFrameLeaf* l) {
-            auto& cs = l->clients;
-            if (std::find(cs.begin(), cs.end(), client) != cs.end()) {
-                frame = l->thisLeaf();
-            }
-        });
-    return frame;
+    return root_->frameWithClient(client);
 }
 
 bool FrameTree::contains(std::shared_ptr<HSFrame> frame) const
@@ -326,9 +349,7 @@ bool FrameTree::focusClient(Client* client) {
         return false;
     }
     // 1. focus client within its frame
-    auto& cs = frameLeaf->clients;
-    int index = std::find(cs.begin(), cs.end(), client) - cs.begin();
-    frameLeaf->selection = index;
+    frameLeaf->select(client);
     // 2. make the frame focused
     focusFrame(frameLeaf);
     return true;
@@ -341,9 +362,9 @@ void FrameTree::focusFrame(shared_ptr<HSFrame> frame) {
             break;
         }
         if (parent->firstChild() == frame) {
-            parent->selection_ = 0;
+            parent->setSelection(0);
         } else {
-            parent->selection_ = 1;
+            parent->setSelection(1);
         }
         frame = parent;
     }
@@ -576,9 +597,10 @@ void FrameTree::applyFrameTree(shared_ptr<HSFrame> target,
             targetSplit = {};
         }
         // make the targetLeaf look like the sourceLeaf
-        targetLeaf->clients = clients;
+        targetLeaf->removeAllClients();
+        targetLeaf->addClients(clients);
         targetLeaf->setSelection(sourceLeaf->selection);
-        targetLeaf->layout = sourceLeaf->layout;
+        targetLeaf->setLayout(sourceLeaf->layout);
     } else {
         // assert that target is a HSFrameSplit
         if (targetLeaf) {
@@ -591,6 +613,7 @@ void FrameTree::applyFrameTree(shared_ptr<HSFrame> target,
         targetSplit->align_ = sourceSplit->align_;
         targetSplit->fraction_ = sourceSplit->fraction_;
         targetSplit->selection_ = sourceSplit->selection_;
+        targetSplit->invalidateLayout();
         applyFrameTree(targetSplit->a_, sourceSplit->a_);
         applyFrameTree(targetSplit->b_, sourceSplit->b_);
     }
@@ -604,6 +627,7 @@ void FrameTree::replaceNode(shared_ptr<HSFrame> old,
         root_ = replacement;
         // root frame should never have a parent:
         root_->parent_ = {};
+        root_->invalidateLayout();
     } else {
         parent->replaceChild(old, replacement);
     }
@@ -774,7 +798,11 @@ int FrameTree::dumpLayoutCommand(Input input, Output output) {
             frame = tree->root_;
         }
     }
-    if (input.command() == "dump") {
+    if (outputFormat(output) == OutputFormat::Json) {
+        // both commands provide the same information
+        JsonWriter json(output);
+        FrameTree::dumpJson(frame, get_current_monitor()->tag->frame->focusedFrame(), json);
+    } else if (input.command() == "dump") {
         FrameTree::dump(frame, output);
     } else { // input.command() == "layout"
         FrameTree::prettyPrint(frame, output);
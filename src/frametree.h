@@ -12,6 +12,7 @@ class Completion;
 class HSFrame;
 class HSFrameLeaf;
 class HSTag;
+class JsonWriter;
 class RawFrameNode;
 class Settings;
 class TreeInterface;
@@ -26,6 +27,8 @@ public:
 
     static void dump(std::shared_ptr<HSFrame> frame, Output output);
     static void prettyPrint(std::shared_ptr<HSFrame> frame, Output output);
+    static void dumpJson(std::shared_ptr<HSFrame> frame,
+                         std::shared_ptr<HSFrameLeaf> focus, JsonWriter& json);
     std::shared_ptr<HSFrame> lookup(const std::string& path);
     static std::shared_ptr<HSFrameLeaf> focusedFrame(std::shared_ptr<HSFrame> node);
     std::shared_ptr<HSFrameLeaf> focusedFrame();
@@ -1,9 +1,13 @@
 #include "hlwmcommon.h"
 
+#include <map>
+#include <set>
 #include <sstream>
 
 #include "clientmanager.h"
 #include "command.h"
+#include "debug.h"
+#include "object.h"
 #include "root.h"
 
 using std::make_pair;
@@ -24,15 +28,179 @@ const std::unordered_map<Window, Client*>& HlwmCommon::clients() {
     return root_->clients->clients();
 }
 
+/** A stream buffer that appends to a string. In contrast to a
+ * std::stringbuf, its memory is kept when it is cleared for the next call.
+ */
+class OutputBuffer : public std::streambuf {
+public:
+    string text;
+protected:
+    int_type overflow(int_type ch) override {
+        if (ch != traits_type::eof()) {
+            text.push_back(traits_type::to_char_type(ch));
+        }
+        return ch;
+    }
+    std::streamsize xsputn(const char* s, std::streamsize count) override {
+        text.append(s, count);
+        return count;
+    }
+};
+
+//! commands that only read the state, such that their reply can be reused
+static const std::set<string> readOnlyQueries = {
+    "complete", "complete_shell", "disjoin_rects", "dump", "get", "get_attr",
+    "get_attrs", "layout", "list_commands", "list_keybinds", "list_monitors",
+    "list_padding", "list_rules", "monitor_rect", "object_tree", "snapshot",
+    "stack", "tag_status", "version",
+};
+
+static bool isReadOnlyQuery(const vector<string>& call) {
+    if (call.empty()) {
+        return false;
+    }
+    if (call[0] == "attr") {
+        // 'attr PATH NEWVALUE' sets an attribute
+        return call.size() <= 2;
+    }
+    return readOnlyQueries.count(call[0]) > 0;
+}
+
+//! queries whose arguments are object paths or glob patterns thereof
+static const std::set<string> objectQueries = {
+    "attr", "get_attr", "get_attrs", "object_tree", "snapshot",
+};
+
+/** whether the reply of a read-only query may be reused. The debug
+ * counters change without notifying anyone, so no query may be cached
+ * whose reply possibly contains one of them. That is any object query
+ * at the root or whose path does not name a child of the root other
+ * than 'debug'.
+ */
+static bool isCacheable(const vector<string>& call) {
+    if (objectQueries.count(call[0]) == 0) {
+        return true;
+    }
+    if (call.size() < 2) {
+        // the query covers the entire object tree
+        return false;
+    }
+    for (size_t i = 1; i < call.size(); i++) {
+        string first = call[i].substr(0, call[i].find('.'));
+        if (first.empty() || first == "debug"
+            || first.find_first_of("*?[") != string::npos)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** The replies to read-only queries. They remain valid as long as no
+ * X event has been handled, no other command has been called and no
+ * attribute or object has changed.
+ */
+class QueryCache {
+public:
+    typedef pair<vector<string>, OutputFormat> Key;
+    static const size_t maxEntries = 64;
+    static unsigned long stateGeneration;
+
+    const pair<int,string>* find(const Key& key) {
+        invalidateIfStale();
+        auto it = replies_.find(key);
+        return (it != replies_.end()) ? &(it->second) : nullptr;
+    }
+    void insert(const Key& key, const pair<int,string>& reply) {
+        invalidateIfStale();
+        if (replies_.size() >= maxEntries) {
+            replies_.clear();
+        }
+        replies_[key] = reply;
+    }
+private:
+    void invalidateIfStale() {
+        if (stateGeneration_ != stateGeneration
+            || treeGeneration_ != Object::treeGeneration()
+            || valueGeneration_ != Object::valueGeneration())
+        {
+            replies_.clear();
+            stateGeneration_ = stateGeneration;
+            treeGeneration_ = Object::treeGeneration();
+            valueGeneration_ = Object::valueGeneration();
+        }
+    }
+    std::map<Key, pair<int,string>> replies_;
+    unsigned long stateGeneration_ = 0;
+    unsigned long treeGeneration_ = 0;
+    unsigned long valueGeneration_ = 0;
+};
+
+unsigned long QueryCache::stateGeneration = 0;
+
+void HlwmCommon::invalidateQueries() {
+    QueryCache::stateGeneration++;
+}
+
+//! marks the shared output buffer as used while it exists
+class BufferUse {
+public:
+    BufferUse(bool& inUse) : inUse_(inUse) { inUse_ = true; }
+    ~BufferUse() { inUse_ = false; }
+private:
+    bool& inUse_;
+};
+
 //! wrapper around Commands::call()
-pair<int,string> HlwmCommon::callCommand(const vector<string>& call) {
+pair<int,string> HlwmCommon::callCommand(const vector<string>& call,
+                                         OutputFormat format) {
+    static OutputBuffer buffer;
+    static std::ostream bufferStream(&buffer);
+    static const std::ios defaultFormat(nullptr);
+    static bool bufferInUse = false;
+    static QueryCache queryCache;
     // the call consists of the command and its arguments
-    std::ostringstream output;
     auto input =
         (call.size() == 0)
         ? Input("", call)
         : Input(call[0], vector<string>(call.begin() + 1, call.end()));
-    int status = Commands::call(input, output);
-    return make_pair(status, output.str());
+    if (bufferInUse) {
+        // this is a nested call, so it can not share the buffer
+        std::ostringstream output;
+        setOutputFormat(output, format);
+        int status = Commands::call(input, output);
+        return make_pair(status, output.str());
+    }
+    QueryCacheStats& cacheStats = Root::get()->debug->queries;
+    bool readOnly = isReadOnlyQuery(call);
+    bool cacheable = readOnly && cacheStats.enabled() && isCacheable(call);
+    QueryCache::Key key = make_pair(call, format);
+    if (cacheable) {
+        auto reply = queryCache.find(key);
+        if (reply) {
+            cacheStats.hits++;
+            return *reply;
+        }
+        cacheStats.misses++;
+    }
+    int status;
+    {
+        BufferUse use(bufferInUse);
+        buffer.text.clear();
+        // undo the stream state and manipulators of the previous call
+        bufferStream.clear();
+        bufferStream.copyfmt(defaultFormat);
+        setOutputFormat(bufferStream, format);
+        status = Commands::call(input, bufferStream);
+    }
+    // copy the text, such that the buffer keeps its memory
+    pair<int,string> reply(status, string());
+    reply.second.assign(buffer.text);
+    if (cacheable) {
+        queryCache.insert(key, reply);
+    } else if (!readOnly) {
+        // the command may have changed something that is not an attribute
+        invalidateQueries();
+    }
+    return reply;
 }
-
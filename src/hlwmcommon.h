@@ -1,9 +1,13 @@
 #pragma once
 
 #include <X11/X.h>
+#include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "outputformat.h"
+
 class Root;
 class Client;
 
@@ -16,7 +20,10 @@ public:
     //! The Client object for a window or nullptr if unmanaged.
     Client* client(Window window);
     const std::unordered_map<Window, Client*>& clients();
-    static std::pair<int,std::string> callCommand(const std::vector<std::string>& call);
+    static std::pair<int,std::string> callCommand(const std::vector<std::string>& call,
+                                                  OutputFormat format = OutputFormat::Text);
+    //! forget the cached replies of read-only queries, e.g. after X events
+    static void invalidateQueries();
 private:
     Root* root_;
 };
@@ -1,5 +1,6 @@
 #include "hook.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 
@@ -11,10 +12,37 @@
 using std::string;
 using std::vector;
 
-void hook_emit(vector<string> args) {
+static int g_hook_deferrals = 0;
+static vector<vector<string>> g_deferred_hooks;
+
+void hook_emit(const vector<string>& args) {
+    if (g_hook_deferrals > 0) {
+        g_deferred_hooks.push_back(args);
+        return;
+    }
     Root::get()->ipcServer_.emitHook(args);
 }
 
+HookDeferral::HookDeferral() {
+    g_hook_deferrals++;
+}
+
+HookDeferral::~HookDeferral() {
+    g_hook_deferrals--;
+    if (g_hook_deferrals > 0) {
+        return;
+    }
+    vector<vector<string>> hooks;
+    hooks.swap(g_deferred_hooks);
+    for (auto it = hooks.begin(); it != hooks.end(); it++) {
+        // skip this hook if it is repeated later on
+        if (std::find(it + 1, hooks.end(), *it) != hooks.end()) {
+            continue;
+        }
+        hook_emit(*it);
+    }
+}
+
 void emit_tag_changed(HSTag* tag, int monitor) {
     assert(tag != nullptr);
     static char monitor_name[STRING_BUF_SIZE];
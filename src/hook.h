@@ -21,7 +21,17 @@ public:
     virtual void attributeChanged(Object* sender, std::string attribute_name) {}
 };
 
-void hook_emit(std::vector<std::string> args);
+void hook_emit(const std::vector<std::string>& args);
+
+/** While an instance of this class exists, hooks are collected instead of
+ * being emitted. When the last instance is destroyed, the collected hooks
+ * are emitted in order, and of identical hooks only the last one is kept.
+ */
+class HookDeferral {
+public:
+    HookDeferral();
+    ~HookDeferral();
+};
 void emit_tag_changed(HSTag* tag, int monitor);
 
 #endif
@@ -1,36 +1,97 @@
 #include "hookmanager.h"
 
+#include "completion.h"
+#include "ipc-protocol.h"
+#include "namedhook.h"
+#include "root.h"
+#include "rootcommands.h"
 #include "utils.h"
 
 using std::endl;
 using std::string;
 
 HookManager::HookManager()
-    : add_("add"), remove_("remove") {
+    : add_("add"), remove_("remove")
+{
     wireActions({ &add_, &remove_ });
 }
 
-void HookManager::ls(Path path, Output out)
+HookManager::~HookManager() = default;
+
+void HookManager::add(const string &path)
 {
-    if (path.empty())
-        return Object::ls(out);
+    auto it = watches_.find(path);
+    if (it != watches_.end()) {
+        it->second->addWatcher();
+        return;
+    }
+    NamedHook* hook = new NamedHook(root_, path);
+    watches_[path] = hook;
+    addIndexed(hook);
+}
+
+void HookManager::remove(const string &path)
+{
+    auto it = watches_.find(path);
+    if (it == watches_.end() || it->second->removeWatcher()) {
+        return;
+    }
+    int index = index_of(it->second);
+    watches_.erase(it);
+    removeIndexed(index);
+}
+
+int HookManager::watchCommand(Input input, Output output)
+{
+    string path;
+    if (!(input >> path)) {
+        return HERBST_NEED_MORE_ARGS;
+    }
+    if (path.empty()) {
+        output << input.command() << ": the attribute path must not be empty" << endl;
+        return HERBST_INVALID_ARGUMENT;
+    }
+    add(path);
+    return 0;
+}
 
-    auto child = join_strings(path, ".");
-    if (children_.find(child) != children_.end()) {
-        children_[child]->ls({}, out);
+void HookManager::watchCompletion(Completion& complete)
+{
+    if (complete == 0) {
+        root_->root_commands->completeAttributePath(complete);
     } else {
-        out << "child " << child << " not found!" << endl; // TODO
+        complete.none();
     }
 }
 
-void HookManager::add(const string &path)
+int HookManager::unwatchCommand(Input input, Output output)
 {
-    //auto h = make_shared<NamedHook>(path);
-    //h->hook_into(Root::get());
-    //addChild(h, "???");
+    string path;
+    if (!(input >> path)) {
+        return HERBST_NEED_MORE_ARGS;
+    }
+    if (watches_.find(path) == watches_.end()) {
+        output << input.command() << ": \"" << path << "\" is not watched" << endl;
+        return HERBST_INVALID_ARGUMENT;
+    }
+    remove(path);
+    return 0;
 }
 
-void HookManager::remove(const string &path)
+void HookManager::unwatchCompletion(Completion& complete)
 {
-    removeChild(path);
+    if (complete == 0) {
+        for (const auto& it : watches_) {
+            complete.full(it.first);
+        }
+    } else {
+        complete.none();
+    }
+}
+
+void HookManager::checkWatches()
+{
+    for (NamedHook* hook : *this) {
+        hook->check();
+    }
 }
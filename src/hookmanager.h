@@ -1,23 +1,45 @@
 #ifndef HOOKMANAGER_H
 #define HOOKMANAGER_H
 
+#include <map>
+#include <string>
+
 #include "attribute.h"
-#include "object.h"
+#include "indexingobject.h"
+#include "namedhook.h"
+
+class Completion;
+class Root;
 
-class HookManager : public Object
+/** The 'hooks' object. Its children are the attribute watches, indexed in
+ * the order in which they were added.
+ */
+class HookManager : public IndexingObject<NamedHook>
 {
 public:
     HookManager();
+    ~HookManager();
+    void injectDependencies(Root* root) { root_ = root; }
 
-    // custom handling (hook names contain '.', they never have children)
-    void ls(Path path, Output out) override;
-
+    //! watch the path, or count another watcher if it is watched already
     void add(const std::string &path);
+    //! remove one watcher, and the watch itself if it was the last one
     void remove(const std::string &path);
 
+    int watchCommand(Input input, Output output);
+    void watchCompletion(Completion& complete);
+    int unwatchCommand(Input input, Output output);
+    void unwatchCompletion(Completion& complete);
+
+    //! emit a hook for every watched attribute whose value has changed
+    void checkWatches();
+
 private:
     Action add_;
     Action remove_;
+    Root* root_ = nullptr;
+    //! the watches by their path
+    std::map<std::string, NamedHook*> watches_;
 };
 
 
@@ -1,6 +1,8 @@
 #ifndef __HERBST_IPC_PROTOCOL_H_
 #define __HERBST_IPC_PROTOCOL_H_
 
+#include <stdint.h>
+
 #define HERBST_IPC_CLASS "HERBST_IPC_CLASS"
 //#define HERBST_IPC_READY "HERBST_IPC_READY"
 //#define HERBST_IPC_ATOM  "_HERBST_IPC"
@@ -14,6 +16,66 @@
 // maximum number of hooks to buffer
 #define HERBST_HOOK_PROPERTY_COUNT 10
 
+/* Socket transport: herbstluftwm listens on a unix domain socket whose path
+ * is announced in the HERBST_IPC_SOCKET_ATOM property of the root window.
+ * Every message on the socket consists of a HerbstIpcHeader followed by
+ * 'length' bytes of payload (all integers in host byte order):
+ *   - the payload of a HERBST_IPC_MSG_CALL is the list of arguments, each
+ *     terminated by a null character.
+ *   - the payload of a HERBST_IPC_MSG_REPLY is the output of the command
+ *     and the header's 'status' field holds its exit status.
+ *   - in a call, the 'status' field selects the format of the output. If a
+ *     command does not support the requested format, it prints plain text.
+ * A client may send further calls before the replies to the previous ones
+ * arrived. Each reply carries the 'id' of the call it answers. herbstluftwm
+ * closes the connection of a client whose message has more than 1 MiB of
+ * payload.
+ *
+ * A HERBST_IPC_MSG_SUBSCRIBE is answered by a reply. Its payload has the
+ * same format as a call and holds a filter: a list of extended regular
+ * expressions, where the i'th one has to be found in the i'th argument of a
+ * hook (if the hook has that many arguments). If a regular expression is
+ * invalid, the reply has a non-zero status. Otherwise, from then on, every
+ * hook passing the filter is sent to the client as a HERBST_IPC_MSG_HOOK
+ * whose payload has the same format as a call and whose 'id' is a sequence
+ * number, counting from 0 for every subscriber. If the
+ * client does not read its hooks fast enough, herbstluftwm drops further
+ * hooks. As soon as there is space again, it sends a HERBST_IPC_MSG_HOOKS_LOST
+ * whose 'id' is the sequence number of the first dropped hook and whose
+ * 'status' is the number of dropped hooks.
+ *
+ * Right after accepting a connection, herbstluftwm sends a
+ * HERBST_IPC_MSG_HELLO whose payload is the token announced in the
+ * HERBST_IPC_TOKEN_ATOM property of the root window. A client only uses the
+ * socket if the two agree, because otherwise the socket belongs to another
+ * herbstluftwm instance, e.g. on the other end of 'ssh -X'. herbstluftwm
+ * only accepts connections from processes of its own user.
+ */
+#define HERBST_IPC_SOCKET_ATOM "__HERBST_IPC_SOCKET"
+#define HERBST_IPC_TOKEN_ATOM "__HERBST_IPC_TOKEN"
+
+enum {
+    HERBST_IPC_MSG_CALL = 1,
+    HERBST_IPC_MSG_REPLY,
+    HERBST_IPC_MSG_SUBSCRIBE,
+    HERBST_IPC_MSG_HOOK,
+    HERBST_IPC_MSG_HOOKS_LOST,
+    HERBST_IPC_MSG_HELLO,
+};
+
+// the output formats a call can request in the 'status' field of its header
+enum {
+    HERBST_IPC_FORMAT_TEXT = 0,
+    HERBST_IPC_FORMAT_JSON,
+};
+
+typedef struct {
+    uint32_t type;   // one of HERBST_IPC_MSG_*
+    uint32_t id;     // chosen by the client, copied to the reply
+    int32_t  status; // exit status in replies, HERBST_IPC_FORMAT_* in calls
+    uint32_t length; // number of bytes following the header
+} HerbstIpcHeader;
+
 // function exit codes
 enum {
     HERBST_EXIT_SUCCESS = 0,
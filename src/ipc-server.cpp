@@ -3,15 +3,68 @@
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <random>
 
+#include "globals.h"
 #include "ipc-protocol.h"
 #include "xconnection.h"
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 using std::make_pair;
+using std::regex;
 using std::string;
+using std::to_string;
 using std::vector;
 
+//! the number of bytes that may be queued for a connection before hooks are
+//dropped for it
+static const size_t maxHookBacklog = 256 * 1024;
+
+//! the number of calls of one connection that are run before the main loop
+//gets the chance to handle X events again
+static const size_t maxCallsPerRound = 32;
+
+//! the maximal payload of a message from a client. A connection sending a
+//longer one is closed, such that no client can make us buffer without bound
+static const size_t maxMessageLength = 1024 * 1024;
+
+//! whether the error of a read or write only says that it would block
+static bool wouldBlock(int error) {
+#if EAGAIN != EWOULDBLOCK
+    if (error == EWOULDBLOCK) {
+        return true;
+    }
+#endif
+    return error == EAGAIN;
+}
+
+//! append a message of the socket protocol to the given buffer
+static void appendMessage(string& buffer, uint32_t type, uint32_t id,
+                          int32_t status, const string& payload)
+{
+    HerbstIpcHeader header;
+    header.type = type;
+    header.id = id;
+    header.status = status;
+    header.length = payload.size();
+    buffer.append((const char*)&header, sizeof(header));
+    buffer += payload;
+}
+
 IpcServer::IpcServer(XConnection& xconnection)
     : X(xconnection)
     , nextHookNumber_(0)
@@ -30,14 +83,373 @@ IpcServer::IpcServer(XConnection& xconnection)
     // set its window id in root window
     XChangeProperty(X.display(), X.root(), X.atom(HERBST_HOOK_WIN_ID_ATOM),
         XA_ATOM, 32, PropModeReplace, (unsigned char*)&hookEventWindow_, 1);
+    openSocket();
 }
 
 IpcServer::~IpcServer() {
+    closeSocket();
     // remove property from root window
     XDeleteProperty(X.display(), X.root(), X.atom(HERBST_HOOK_WIN_ID_ATOM));
     XDestroyWindow(X.display(), hookEventWindow_);
 }
 
+//! make the file descriptor non-blocking and hide it from spawned processes
+static void setupSocketFd(int fd) {
+    fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+//! a token that distinguishes this instance from others on the same machine
+static string generateToken() {
+    unsigned int words[4];
+    try {
+        std::random_device device;
+        for (auto& w : words) {
+            w = device();
+        }
+    } catch (const std::exception&) {
+        // not random, but still distinct from other running instances
+        words[0] = (unsigned int)getpid();
+        words[1] = (unsigned int)time(nullptr);
+        words[2] = (unsigned int)clock();
+        words[3] = getuid();
+    }
+    char text[4 * 8 + 1];
+    snprintf(text, sizeof(text), "%08x%08x%08x%08x",
+             words[0], words[1], words[2], words[3]);
+    return text;
+}
+
+//! whether the process on the other end of the socket runs as our user
+static bool peerIsSameUser(int fd) {
+#if defined(__linux__) && defined(SO_PEERCRED)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) {
+        return false;
+    }
+    return cred.uid == getuid();
+#elif defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__) \
+    || defined(__DragonFly__) || defined(__APPLE__)
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(fd, &uid, &gid) != 0) {
+        return false;
+    }
+    return uid == getuid();
+#else
+    // rely on the permissions of the socket file
+    (void)fd;
+    return true;
+#endif
+}
+
+/** Create the listening socket and announce its path on the root window.
+ * If this fails, then the clients fall back to the property protocol.
+ */
+void IpcServer::openSocket() {
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    string display = DisplayString(X.display());
+    // the display name may contain slashes, e.g. on macOS
+    for (auto& ch : display) {
+        if (ch == '/') {
+            ch = '_';
+        }
+    }
+    socketPath_ = string(runtimeDir ? runtimeDir : "/tmp")
+        + "/herbstluftwm-" + to_string(getuid()) + "-" + display;
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath_.size() >= sizeof(addr.sun_path)) {
+        HSWarning("socket path \"%s\" is too long, using X properties only\n",
+                  socketPath_.c_str());
+        socketPath_ = "";
+        return;
+    }
+    strncpy(addr.sun_path, socketPath_.c_str(), sizeof(addr.sun_path) - 1);
+    listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd_ < 0) {
+        HSWarning("cannot create ipc socket: %s\n", strerror(errno));
+        socketPath_ = "";
+        return;
+    }
+    setupSocketFd(listenFd_);
+    // remove a stale socket of a previous instance
+    unlink(socketPath_.c_str());
+    // only the current user may connect
+    mode_t oldUmask = umask(0077);
+    int status = bind(listenFd_, (struct sockaddr*)&addr, sizeof(addr));
+    umask(oldUmask);
+    if (status != 0 || listen(listenFd_, 16) != 0) {
+        HSWarning("cannot listen on ipc socket \"%s\": %s\n",
+                  socketPath_.c_str(), strerror(errno));
+        close(listenFd_);
+        listenFd_ = -1;
+        socketPath_ = "";
+        return;
+    }
+    token_ = generateToken();
+    X.setPropertyString(X.root(), X.atom(HERBST_IPC_TOKEN_ATOM), token_);
+    X.setPropertyString(X.root(), X.atom(HERBST_IPC_SOCKET_ATOM), socketPath_);
+}
+
+void IpcServer::closeSocket() {
+    for (auto& it : socketConnections_) {
+        close(it.first);
+    }
+    socketConnections_.clear();
+    if (listenFd_ < 0) {
+        return;
+    }
+    close(listenFd_);
+    listenFd_ = -1;
+    unlink(socketPath_.c_str());
+    XDeleteProperty(X.display(), X.root(), X.atom(HERBST_IPC_SOCKET_ATOM));
+    XDeleteProperty(X.display(), X.root(), X.atom(HERBST_IPC_TOKEN_ATOM));
+}
+
+void IpcServer::socketFds(vector<int>& readFds, vector<int>& writeFds) {
+    readFds.clear();
+    writeFds.clear();
+    if (listenFd_ >= 0) {
+        readFds.push_back(listenFd_);
+    }
+    for (auto& it : socketConnections_) {
+        if (!it.second.closing) {
+            readFds.push_back(it.first);
+        }
+        if (!it.second.outBuffer.empty()) {
+            writeFds.push_back(it.first);
+        }
+    }
+}
+
+void IpcServer::handleSocket(int fd, bool readable, bool writable, CallHandler callback) {
+    if (fd == listenFd_) {
+        acceptConnection();
+        return;
+    }
+    auto it = socketConnections_.find(fd);
+    if (it == socketConnections_.end()) {
+        // the connection has been closed in the meantime
+        return;
+    }
+    SocketConnection& con = it->second;
+    if (readable) {
+        // the replies are only written by flushReplies()
+        readConnection(con, callback);
+    }
+    if (writable) {
+        writeConnection(con);
+    }
+    if (con.closing && con.outBuffer.empty() && !hasCompleteMessage(con)) {
+        close(fd);
+        socketConnections_.erase(it);
+    }
+}
+
+void IpcServer::handlePendingCalls(CallHandler callback) {
+    pendingCalls_ = false;
+    for (auto& it : socketConnections_) {
+        processCalls(it.second, callback);
+    }
+}
+
+bool IpcServer::hasCompleteMessage(const SocketConnection& con) {
+    if (con.inBuffer.size() < sizeof(HerbstIpcHeader)) {
+        return false;
+    }
+    HerbstIpcHeader header;
+    memcpy(&header, con.inBuffer.data(), sizeof(header));
+    return con.inBuffer.size() - sizeof(header) >= header.length;
+}
+
+void IpcServer::flushReplies() {
+    newReplies_ = false;
+    for (auto it = socketConnections_.begin(); it != socketConnections_.end(); ) {
+        SocketConnection& con = it->second;
+        if (!con.outBuffer.empty()) {
+            writeConnection(con);
+        }
+        if (con.closing && con.outBuffer.empty() && !hasCompleteMessage(con)) {
+            close(it->first);
+            it = socketConnections_.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+void IpcServer::acceptConnection() {
+    int fd = accept(listenFd_, nullptr, nullptr);
+    if (fd < 0) {
+        return;
+    }
+    if (!peerIsSameUser(fd)) {
+        // the socket may be reachable by others, e.g. in /tmp
+        HSWarning("ipc socket: refusing connection of another user\n");
+        close(fd);
+        return;
+    }
+    setupSocketFd(fd);
+    SocketConnection& con = socketConnections_[fd];
+    con.fd = fd;
+    appendMessage(con.outBuffer, HERBST_IPC_MSG_HELLO, 0, 0, token_);
+    newReplies_ = true;
+}
+
+//! read all available data and run the calls that are complete
+void IpcServer::readConnection(SocketConnection& con, CallHandler callback) {
+    char buf[4096];
+    // the calls of a client that does not wait for its replies are read
+    // in the next main loop iteration, once the complete ones have run
+    while (con.inBuffer.size() < sizeof(HerbstIpcHeader) + maxMessageLength) {
+        ssize_t count = read(con.fd, buf, sizeof(buf));
+        if (count > 0) {
+            con.inBuffer.append(buf, count);
+            continue;
+        }
+        if (count < 0 && (errno == EINTR)) {
+            continue;
+        }
+        if (count == 0 || !wouldBlock(errno)) {
+            con.closing = true;
+        }
+        break;
+    }
+    processCalls(con, callback);
+}
+
+//! run the calls that are complete, but at most maxCallsPerRound of them
+void IpcServer::processCalls(SocketConnection& con, CallHandler callback) {
+    size_t pos = 0;
+    size_t calls = 0;
+    while (con.inBuffer.size() - pos >= sizeof(HerbstIpcHeader)) {
+        if (calls >= maxCallsPerRound) {
+            // leave the rest for the next main loop iteration
+            pendingCalls_ = true;
+            break;
+        }
+        HerbstIpcHeader header;
+        memcpy(&header, con.inBuffer.data() + pos, sizeof(header));
+        if (header.type != HERBST_IPC_MSG_CALL
+            && header.type != HERBST_IPC_MSG_SUBSCRIBE)
+        {
+            HSWarning("ipc socket: dropping connection after message of "
+                      "unknown type %u\n", header.type);
+            con.closing = true;
+            con.inBuffer.clear();
+            return;
+        }
+        if (header.length > maxMessageLength) {
+            HSWarning("ipc socket: dropping connection after message of "
+                      "%u bytes\n", header.length);
+            con.closing = true;
+            con.inBuffer.clear();
+            return;
+        }
+        if (con.inBuffer.size() - pos - sizeof(header) < header.length) {
+            // wait for the remaining payload
+            break;
+        }
+        const char* payload = con.inBuffer.data() + pos + sizeof(header);
+        vector<string> arguments;
+        size_t argStart = 0;
+        for (size_t i = 0; i < header.length; i++) {
+            if (payload[i] == '\0') {
+                arguments.push_back(string(payload + argStart, i - argStart));
+                argStart = i + 1;
+            }
+        }
+        pos += sizeof(header) + header.length;
+        if (header.type == HERBST_IPC_MSG_SUBSCRIBE) {
+            int status = subscribe(con, arguments);
+            appendMessage(con.outBuffer, HERBST_IPC_MSG_REPLY, header.id,
+                          status, status ? "invalid hook filter\n" : "");
+            newReplies_ = true;
+            continue;
+        }
+        if (header.status != HERBST_IPC_FORMAT_TEXT
+            && header.status != HERBST_IPC_FORMAT_JSON)
+        {
+            appendMessage(con.outBuffer, HERBST_IPC_MSG_REPLY, header.id,
+                          HERBST_INVALID_ARGUMENT, "unknown output format\n");
+            newReplies_ = true;
+            continue;
+        }
+        auto result = callback(arguments, (OutputFormat)header.status);
+        appendMessage(con.outBuffer, HERBST_IPC_MSG_REPLY, header.id,
+                      result.first, result.second);
+        newReplies_ = true;
+        calls++;
+    }
+    con.inBuffer.erase(0, pos);
+}
+
+//! write as much of the pending replies as possible without blocking
+void IpcServer::writeConnection(SocketConnection& con) {
+    size_t written = 0;
+    while (written < con.outBuffer.size()) {
+        ssize_t count = send(con.fd, con.outBuffer.data() + written,
+                             con.outBuffer.size() - written, MSG_NOSIGNAL);
+        if (count > 0) {
+            written += count;
+            continue;
+        }
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0 && !wouldBlock(errno)) {
+            // the peer is gone, so drop what is left
+            con.closing = true;
+            written = con.outBuffer.size();
+        }
+        break;
+    }
+    con.outBuffer.erase(0, written);
+    if (con.lostHooks > 0 && con.outBuffer.size() < maxHookBacklog) {
+        reportLostHooks(con);
+    }
+}
+
+//! let the connection listen for the hooks matching the given filter
+int IpcServer::subscribe(SocketConnection& con, const vector<string>& filter) {
+    vector<regex> patterns;
+    try {
+        for (const auto& source : filter) {
+            patterns.push_back(regex(source, regex::extended));
+        }
+    } catch (const std::regex_error&) {
+        return HERBST_INVALID_ARGUMENT;
+    }
+    con.hookFilter = patterns;
+    con.subscribed = true;
+    return 0;
+}
+
+//! check whether every pattern of the filter occurs in the respective argument
+bool IpcServer::hookPassesFilter(const SocketConnection& con,
+                                 const vector<string>& args)
+{
+    for (size_t i = 0; i < con.hookFilter.size() && i < args.size(); i++) {
+        if (!std::regex_search(args[i], con.hookFilter[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! tell the subscriber about the hooks that were dropped for it
+void IpcServer::reportLostHooks(SocketConnection& con) {
+    if (con.lostHooks == 0 || con.closing) {
+        return;
+    }
+    appendMessage(con.outBuffer, HERBST_IPC_MSG_HOOKS_LOST,
+                  con.nextHook - con.lostHooks, con.lostHooks, "");
+    con.lostHooks = 0;
+}
+
 void IpcServer::addConnection(Window window) {
     XSelectInput(X.display(), window, PropertyChangeMask);
 }
@@ -62,7 +474,7 @@ bool IpcServer::handleConnection(Window win, CallHandler callback) {
     for (int i = 0; i < count; i++) {
         arguments.push_back(list_return[i]);
     }
-    auto result = callback(arguments);
+    auto result = callback(arguments, OutputFormat::Text);
     // send output back
     int status = result.first;
     const string& output = result.second;
@@ -82,7 +494,7 @@ bool IpcServer::isConnectable(Window window) {
     return X.getClass(window) == HERBST_IPC_CLASS;
 }
 
-void IpcServer::emitHook(vector<string> args) {
+void IpcServer::emitHook(const vector<string>& args) {
     if (args.size() <= 0) {
         // nothing to do
         return;
@@ -93,4 +505,27 @@ void IpcServer::emitHook(vector<string> args) {
     // set counter for next property
     nextHookNumber_ += 1;
     nextHookNumber_ %= HERBST_HOOK_PROPERTY_COUNT;
+    // queue the hook for the subscribers on the socket
+    string payload;
+    for (const auto& arg : args) {
+        payload += arg;
+        payload += '\0';
+    }
+    for (auto& it : socketConnections_) {
+        SocketConnection& con = it.second;
+        if (!con.subscribed || con.closing || !hookPassesFilter(con, args)) {
+            continue;
+        }
+        if (con.outBuffer.size() >= maxHookBacklog) {
+            // the subscriber is too slow, so drop the hook but still
+            // count it such that the subscriber notices the gap
+            con.nextHook++;
+            con.lostHooks++;
+            continue;
+        }
+        reportLostHooks(con);
+        appendMessage(con.outBuffer, HERBST_IPC_MSG_HOOK, con.nextHook, 0, payload);
+        con.nextHook++;
+        newReplies_ = true;
+    }
 }
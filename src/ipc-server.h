@@ -2,11 +2,16 @@
 #define __HERBSTLUFT_IPC_SERVER_H_
 
 #include <X11/X.h>
+#include <cstdint>
 #include <functional>
+#include <map>
+#include <regex>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "outputformat.h"
+
 class XConnection;
 
 class IpcServer {
@@ -14,7 +19,9 @@ public:
     //! a callback that handles a call, represented by a vector of strings. The
     // callback can produce some output and return a status code.
     // This is the counterpart of hc_send_command() in ipc-client/ipc-client.h
-    using CallHandler = std::function<std::pair<int,std::string>(const std::vector<std::string>&)>;
+    // The output format is only relevant for calls via the socket.
+    using CallHandler = std::function<std::pair<int,std::string>(
+                            const std::vector<std::string>&, OutputFormat)>;
     IpcServer(XConnection& xconnection);
     ~IpcServer();
 
@@ -26,12 +33,60 @@ public:
     //! try to run an ipc request in the given window via the given callback,
     //return if there was one
     bool handleConnection(Window window, CallHandler callback);
-    //! send a hook to all listening clients
-    void emitHook(std::vector<std::string> args);
+    //! send a hook to all listening clients. For subscribers on the
+    //socket, the hook is only queued until the next flushReplies()
+    void emitHook(const std::vector<std::string>& args);
+
+    //! the file descriptors of the socket transport that the main loop has
+    //to watch for being readable resp. writable
+    void socketFds(std::vector<int>& readFds, std::vector<int>& writeFds);
+    //! handle activity on one of the file descriptors from socketFds()
+    void handleSocket(int fd, bool readable, bool writable, CallHandler callback);
+    //! whether some calls have been received but postponed, such that the
+    //main loop can handle X events in between
+    bool hasPendingCalls() { return pendingCalls_; }
+    //! run the next bunch of postponed calls
+    void handlePendingCalls(CallHandler callback);
+    //! whether calls have been answered or hooks have been emitted since the
+    //last flushReplies()
+    bool hasNewReplies() { return newReplies_; }
+    //! send the replies to the handled calls and the queued hooks, as far as
+    //possible without blocking. This has to be called after the requests to
+    //the X server issued by the calls have been processed.
+    void flushReplies();
 
 private:
+    class SocketConnection {
+    public:
+        int fd;
+        std::string inBuffer; //! received bytes of incomplete messages
+        std::string outBuffer; //! replies that are not yet written
+        bool closing = false; //! whether the peer closed its end
+        bool subscribed = false; //! whether the peer listens for hooks
+        std::vector<std::regex> hookFilter; //! patterns for the hook arguments
+        uint32_t nextHook = 0; //! sequence number of the next hook
+        uint32_t lostHooks = 0; //! hooks dropped since the last one queued
+    };
+    void openSocket();
+    void closeSocket();
+    void acceptConnection();
+    void readConnection(SocketConnection& con, CallHandler callback);
+    void processCalls(SocketConnection& con, CallHandler callback);
+    static bool hasCompleteMessage(const SocketConnection& con);
+    void writeConnection(SocketConnection& con);
+    int subscribe(SocketConnection& con, const std::vector<std::string>& filter);
+    void reportLostHooks(SocketConnection& con);
+    static bool hookPassesFilter(const SocketConnection& con,
+                                 const std::vector<std::string>& args);
     XConnection& X;
 
+    int listenFd_ = -1; //! the listening socket or -1 if not available
+    std::string socketPath_;
+    std::string token_; //! identifies this instance towards the clients
+    std::map<int, SocketConnection> socketConnections_;
+    bool newReplies_ = false;
+    bool pendingCalls_ = false;
+
     Window hookEventWindow_; //! window on which the hooks are announced
     int nextHookNumber_; //! index for the next hook
 };
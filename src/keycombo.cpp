@@ -79,12 +79,19 @@ template<> ModifiersWithString Converter<ModifiersWithString>::parse(const strin
 
 template<> string Converter<ModifiersWithString>::str(ModifiersWithString payload)
 {
-    std::stringstream str;
+    string text;
+    append(text, payload);
+    return text;
+}
+
+template<> void Converter<ModifiersWithString>::append(string& buffer,
+                                                       const ModifiersWithString& payload)
+{
     for (auto& modName : ModifierCombo::getNamesForModifierMask(payload.modifiers_)) {
-        str << modName << ModifierCombo::separators[0];
+        buffer += modName;
+        buffer += ModifierCombo::separators[0];
     }
-    str << payload.suffix_;
-    return str.str();
+    buffer += payload.suffix_;
 }
 
 template<> void Converter<ModifiersWithString>::complete(Completion& complete, ModifiersWithString const*)
@@ -201,10 +208,15 @@ vector<string> ModifierCombo::getNamesForModifierMask(unsigned int mask) {
 
 void KeyCombo::complete(Completion& complete) {
     ModifiersWithString::complete(complete, [] (Completion& compWrapped, string prefix) {
-        // Offer full completions for a final keysym:
-        auto keySyms = XKeyGrabber::getPossibleKeySyms();
-        for (auto keySym : keySyms) {
-            compWrapped.full(prefix + keySym);
+        // Offer full completions for a final keysym. The keysyms are
+        // sorted, so the matching ones form a contiguous range
+        const auto& keySyms = XKeyGrabber::getPossibleKeySyms();
+        string symPrefix = compWrapped.needle().substr(prefix.size());
+        for (auto it = std::lower_bound(keySyms.begin(), keySyms.end(), symPrefix);
+             it != keySyms.end() && Completion::prefixOf(symPrefix, *it);
+             it++)
+        {
+            compWrapped.full(prefix + *it);
         }
     });
 }
@@ -9,6 +9,7 @@
 
 #include "client.h"
 #include "command.h"
+#include "debug.h"
 #include "floating.h"
 #include "frametree.h" // TODO: remove this dependency!
 #include "globals.h"
@@ -28,6 +29,27 @@ using std::swap;
 using std::vector;
 using std::weak_ptr;
 
+FrameLayoutSettings::FrameLayoutSettings(Settings* settings)
+    : smartFrameSurroundings_(settings->smart_frame_surroundings())
+    , smartWindowSurroundings_(settings->smart_window_surroundings())
+    , gaplessGrid_(settings->gapless_grid())
+    , frameGap_(settings->frame_gap())
+    , frameBorderWidth_(settings->frame_border_width())
+    , framePadding_(settings->frame_padding())
+    , windowGap_(settings->window_gap())
+{
+}
+
+bool FrameLayoutSettings::operator==(const FrameLayoutSettings& other) const {
+    return smartFrameSurroundings_ == other.smartFrameSurroundings_
+        && smartWindowSurroundings_ == other.smartWindowSurroundings_
+        && gaplessGrid_ == other.gaplessGrid_
+        && frameGap_ == other.frameGap_
+        && frameBorderWidth_ == other.frameBorderWidth_
+        && framePadding_ == other.framePadding_
+        && windowGap_ == other.windowGap_;
+}
+
 /* create a new frame
  * you can either specify a frame or a tag as its parent
  */
@@ -64,47 +86,78 @@ void HSFrameLeaf::insertClient(Client* client, bool focus) {
     // insert it after the selection
     int index = std::min((selection + 1), (int)clients.size());
     clients.insert(clients.begin() + index, client);
+    updateClientIndex(index);
     if (focus) {
         selection = index;
     }
+    invalidateLayout();
     // FRAMETODO: if we we are focused, and were empty before, we have to focus
     // the client now
 }
 
-shared_ptr<HSFrameLeaf> HSFrameSplit::frameWithClient(Client* client) {
-    auto found = a_->frameWithClient(client);
-    if (found) return found;
-    else return b_->frameWithClient(client);
-}
-
-shared_ptr<HSFrameLeaf> HSFrameLeaf::frameWithClient(Client* client) {
-    if (find(clients.begin(), clients.end(), client) != clients.end()) {
-        return thisLeaf();
-    } else {
+shared_ptr<HSFrameLeaf> HSFrame::frameWithClient(Client* client) {
+    // every client knows its frame, so we only need to check that
+    // this frame is the frame itself or one of its ancestors
+    auto leaf = client->frameLeaf_.lock();
+    if (!leaf || leaf->indexOf(client) < 0) {
         return shared_ptr<HSFrameLeaf>();
     }
+    for (shared_ptr<HSFrame> frame = leaf; frame; frame = frame->getParent()) {
+        if (frame.get() == this) {
+            return leaf;
+        }
+    }
+    return shared_ptr<HSFrameLeaf>();
 }
 
-bool HSFrameLeaf::removeClient(Client* client) {
-    auto it = find(clients.begin(), clients.end(), client);
-    if (it != clients.end()) {
-        auto idx = it - clients.begin();
-        clients.erase(it);
-        // find out new selection
-        // if selection was before removed window
-        // then do nothing
-        // else shift it by 1
-        selection -= (selection < idx) ? 0 : 1;
-        // ensure valid index
-        selection = std::max(std::min(selection, ((int)clients.size()) - 1), 0);
-        return true;
-    } else {
+bool HSFrame::removeClient(Client* client) {
+    auto leaf = frameWithClient(client);
+    if (!leaf) {
         return false;
     }
+    leaf->removeClientAt(client->frameLeafIndex_);
+    return true;
+}
+
+int HSFrameLeaf::indexOf(Client* client) {
+    size_t idx = client->frameLeafIndex_;
+    if (idx < clients.size() && clients[idx] == client
+        && client->frameLeaf_.lock().get() == this)
+    {
+        return static_cast<int>(idx);
+    }
+    return -1;
 }
 
-bool HSFrameSplit::removeClient(Client* client) {
-    return a_->removeClient(client) || b_->removeClient(client);
+void HSFrameLeaf::removeClientAt(size_t index) {
+    int idx = static_cast<int>(index);
+    detachClient(clients[index]);
+    clients.erase(clients.begin() + index);
+    updateClientIndex(index);
+    // find out new selection
+    // if selection was before removed window
+    // then do nothing
+    // else shift it by 1
+    selection -= (selection < idx) ? 0 : 1;
+    // ensure valid index
+    selection = std::max(std::min(selection, ((int)clients.size()) - 1), 0);
+    invalidateLayout();
+}
+
+void HSFrameLeaf::updateClientIndex(size_t from) {
+    auto self = thisLeaf();
+    for (size_t i = from; i < clients.size(); i++) {
+        clients[i]->frameLeaf_ = self;
+        clients[i]->frameLeafIndex_ = i;
+    }
+}
+
+void HSFrameLeaf::detachClient(Client* client) {
+    // the client may already have been moved to another frame
+    if (client->frameLeaf_.lock().get() == this) {
+        client->frameLeaf_.reset();
+        client->frameLeafIndex_ = 0;
+    }
 }
 
 
@@ -115,6 +168,38 @@ HSFrameLeaf::~HSFrameLeaf() {
     delete decoration;
 }
 
+const TilingResult& HSFrame::computeLayout(Rectangle rect) {
+    FrameLayoutSettings layoutSettings(settings_);
+    if (!layoutValid_ || !(rect == layoutRect_)
+        || !(layoutSettings == layoutSettings_))
+    {
+        // this reuses the memory of the previous result
+        auto capacity = layoutCache_.capacity();
+        layoutCache_.clear();
+        computeLayoutUncached(rect, layoutCache_);
+        if (layoutCache_.capacity() != capacity) {
+            g_monitors->layoutStats().bufferGrowths++;
+        }
+        layoutRect_ = rect;
+        layoutSettings_ = layoutSettings;
+        layoutValid_ = true;
+    }
+    return layoutCache_;
+}
+
+/** The layout of a split consists of the layouts of its children, so a
+ * change of a frame invalidates all the frames up to the root. The
+ * siblings on that path keep their remembered layout.
+ */
+void HSFrame::invalidateLayout() {
+    layoutValid_ = false;
+    auto parent = parent_.lock();
+    while (parent) {
+        parent->layoutValid_ = false;
+        parent = parent->parent_.lock();
+    }
+}
+
 shared_ptr<HSFrame> HSFrame::root() {
     auto parent_shared = parent_.lock();
     if (parent_shared) return parent_shared->root();
@@ -160,8 +245,7 @@ int frame_current_set_client_layout(int argc, char** argv, Output output) {
     return 0;
 }
 
-TilingResult HSFrameLeaf::layoutLinear(Rectangle rect, bool vertical) {
-    TilingResult res;
+void HSFrameLeaf::layoutLinear(Rectangle rect, bool vertical, TilingResult& res) {
     auto cur = rect;
     int last_step_y;
     int last_step_x;
@@ -193,11 +277,9 @@ TilingResult HSFrameLeaf::layoutLinear(Rectangle rect, bool vertical) {
         cur.x += step_x;
         i++;
     }
-    return res;
 }
 
-TilingResult HSFrameLeaf::layoutMax(Rectangle rect) {
-    TilingResult res;
+void HSFrameLeaf::layoutMax(Rectangle rect, TilingResult& res) {
     for (auto client : clients) {
         TilingStep step(rect);
         if (client == clients[selection]) {
@@ -205,7 +287,6 @@ TilingResult HSFrameLeaf::layoutMax(Rectangle rect) {
         }
         res[client] = step;
     }
-    return res;
 }
 
 void frame_layout_grid_get_size(size_t count, int* res_rows, int* res_cols) {
@@ -221,9 +302,8 @@ void frame_layout_grid_get_size(size_t count, int* res_rows, int* res_cols) {
     }
 }
 
-TilingResult HSFrameLeaf::layoutGrid(Rectangle rect) {
-    TilingResult res;
-    if (clients.size() == 0) return res;
+void HSFrameLeaf::layoutGrid(Rectangle rect, TilingResult& res) {
+    if (clients.size() == 0) return;
 
     int rows, cols;
     frame_layout_grid_get_size(clients.size(), &rows, &cols);
@@ -258,10 +338,9 @@ TilingResult HSFrameLeaf::layoutGrid(Rectangle rect) {
         }
         cur.y += height;
     }
-    return res;
 }
 
-TilingResult HSFrameLeaf::computeLayout(Rectangle rect) {
+void HSFrameLeaf::computeLayoutUncached(Rectangle rect, TilingResult& res) {
     last_rect = rect;
     if (!settings_->smart_frame_surroundings() || parent_.lock()) {
         // apply frame gap
@@ -278,7 +357,6 @@ TilingResult HSFrameLeaf::computeLayout(Rectangle rect) {
     rect.height = std::max(WINDOW_MIN_HEIGHT, rect.height);
 
     // move windows
-    TilingResult res;
     FrameDecorationData frame_data;
     frame_data.geometry = rect;
     frame_data.visible = true;
@@ -287,7 +365,7 @@ TilingResult HSFrameLeaf::computeLayout(Rectangle rect) {
     res.focused_frame = decoration;
     res.add(decoration, frame_data);
     if (clients.size() == 0) {
-        return res;
+        return;
     }
     // whether we should omit the gap around windows:
     bool smart_window_surroundings_active =
@@ -316,35 +394,32 @@ TilingResult HSFrameLeaf::computeLayout(Rectangle rect) {
         rect.width  -= frame_padding * 2;
         rect.height -= frame_padding * 2;
     }
-    TilingResult layoutResult;
     switch (layout) {
         case LayoutAlgorithm::max:
-            layoutResult = layoutMax(rect);
+            layoutMax(rect, res);
             break;
         case LayoutAlgorithm::grid:
-            layoutResult = layoutGrid(rect);
+            layoutGrid(rect, res);
             break;
         case LayoutAlgorithm::vertical:
-            layoutResult = layoutVertical(rect);
+            layoutVertical(rect, res);
             break;
         case LayoutAlgorithm::horizontal:
-            layoutResult = layoutHorizontal(rect);
+            layoutHorizontal(rect, res);
             break;
     }
     if (!smart_window_surroundings_active) {
         // apply window gap: deduct 'window_gap' many pixels from
         // bottom and right of every window:
-        for (auto& it : layoutResult.data) {
+        for (auto& it : res.data) {
             it.second.geometry.width -= window_gap;
             it.second.geometry.height -= window_gap;
         }
     }
-    res.mergeFrom(layoutResult);
     res.focus = clients[selection];
-    return res;
 }
 
-TilingResult HSFrameSplit::computeLayout(Rectangle rect) {
+void HSFrameSplit::computeLayoutUncached(Rectangle rect, TilingResult& res) {
     last_rect = rect;
     auto first = rect;
     auto second = rect;
@@ -357,14 +432,12 @@ TilingResult HSFrameSplit::computeLayout(Rectangle rect) {
         second.x += first.width;
         second.width -= first.width;
     }
-    TilingResult res;
-    auto res1 = a_->computeLayout(first);
-    auto res2 = b_->computeLayout(second);
-    res.mergeFrom(res1);
-    res.mergeFrom(res2);
+    const TilingResult& res1 = a_->computeLayout(first);
+    const TilingResult& res2 = b_->computeLayout(second);
+    res.appendFrom(res1);
+    res.appendFrom(res2);
     res.focus = (selection_ == 0) ? res1.focus : res2.focus;
     res.focused_frame = (selection_ == 0) ? res1.focused_frame : res2.focused_frame;
-    return res;
 }
 
 void HSFrameSplit::fmap(function<void(HSFrameSplit*)> onSplit, function<void(HSFrameLeaf*)> onLeaf, int order) {
@@ -416,6 +489,7 @@ void HSFrameLeaf::setSelection(int index) {
         index = clients.size() - 1;
     }
     selection = index;
+    invalidateLayout();
     clients[selection]->window_focus();
     get_current_monitor()->applyLayout();
 }
@@ -440,11 +514,16 @@ void HSFrameSplit::replaceChild(shared_ptr<HSFrame> old, shared_ptr<HSFrame> new
         b_ = newchild;
         newchild->parent_ = thisSplit();
     }
+    // the new child may have been a root before
+    newchild->invalidateLayout();
 }
 
 void HSFrameLeaf::addClients(const vector<Client*>& vec, bool atFront) {
     auto targetPosition = atFront ? clients.begin() : clients.end();
+    size_t firstChanged = atFront ? 0 : clients.size();
     clients.insert(targetPosition, vec.begin(), vec.end());
+    updateClientIndex(firstChanged);
+    invalidateLayout();
 }
 
 bool HSFrameLeaf::split(SplitAlign alignment, int fraction, size_t childrenLeaving) {
@@ -474,12 +553,14 @@ bool HSFrameLeaf::split(SplitAlign alignment, int fraction, size_t childrenLeavi
         second->setSelection(selection - childrenStaying);
         selection = std::max(0, childrenStaying - 1);
     }
+    invalidateLayout();
     return true;
 }
 
 
 void HSFrameSplit::swapChildren() {
     swap(a_,b_);
+    invalidateLayout();
 }
 
 int frame_change_fraction_command(int argc, char** argv, Output output) {
@@ -530,11 +611,13 @@ int frame_change_fraction_command(int argc, char** argv, Output output) {
 void HSFrameSplit::adjustFraction(int delta) {
     fraction_ += delta;
     fraction_ = clampFraction(fraction_);
+    invalidateLayout();
 }
 
 void HSFrameSplit::setFraction(int fraction)
 {
     fraction_ = clampFraction(fraction);
+    invalidateLayout();
 }
 
 int HSFrameSplit::clampFraction(int fraction)
@@ -649,7 +732,10 @@ int HSFrameLeaf::getInnerNeighbourIndex(Direction direction) {
 
 void HSFrameLeaf::moveClient(int new_index) {
     swap(clients[new_index], clients[selection]);
+    clients[new_index]->frameLeafIndex_ = new_index;
+    clients[selection]->frameLeafIndex_ = selection;
     selection = new_index;
+    invalidateLayout();
 }
 
 int frame_move_window_command(int argc, char** argv, Output output) {
@@ -709,9 +795,10 @@ int frame_move_window_command(int argc, char** argv, Output output) {
 }
 
 void HSFrameLeaf::select(Client* client) {
-    auto it = find(clients.begin(), clients.end(), client);
-    if (it != clients.end()) {
-        selection = it - clients.begin();
+    int idx = indexOf(client);
+    if (idx >= 0 && selection != idx) {
+        selection = idx;
+        invalidateLayout();
     }
 }
 
@@ -791,7 +878,11 @@ void HSFrame::setVisibleRecursive(bool visible) {
 vector<Client*> HSFrameLeaf::removeAllClients() {
     vector<Client*> result;
     swap(result, clients);
+    for (auto client : result) {
+        detachClient(client);
+    }
     selection = 0;
+    invalidateLayout();
     return result;
 }
 
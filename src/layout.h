@@ -21,16 +21,40 @@ class HSFrameLeaf;
 class HSFrameSplit;
 class Settings;
 
+//! the settings that the layout computed for a frame depends on
+class FrameLayoutSettings {
+public:
+    FrameLayoutSettings() = default;
+    FrameLayoutSettings(Settings* settings);
+    bool operator==(const FrameLayoutSettings& other) const;
+private:
+    bool smartFrameSurroundings_ = false;
+    bool smartWindowSurroundings_ = false;
+    bool gaplessGrid_ = false;
+    int frameGap_ = 0;
+    int frameBorderWidth_ = 0;
+    int framePadding_ = 0;
+    int windowGap_ = 0;
+};
+
 class HSFrame : public std::enable_shared_from_this<HSFrame> {
 protected:
     HSFrame(HSTag* tag, Settings* settings, std::weak_ptr<HSFrameSplit> parent);
     virtual ~HSFrame();
 public:
-    virtual std::shared_ptr<HSFrameLeaf> frameWithClient(Client* client) = 0;
-    virtual bool removeClient(Client* client) = 0;
+    //! the leaf in this subtree containing the client, if there is any
+    std::shared_ptr<HSFrameLeaf> frameWithClient(Client* client);
+    bool removeClient(Client* client);
 
     virtual bool isFocused();
-    virtual TilingResult computeLayout(Rectangle rect) = 0;
+    /** the layout of the frame in the given rectangle. The result is
+     * remembered, such that subtrees that did not change since the last
+     * call do not need to be computed again. The returned reference is
+     * valid until the next call.
+     */
+    const TilingResult& computeLayout(Rectangle rect);
+    //! mark the remembered layout of this frame and its ancestors outdated
+    void invalidateLayout();
     virtual Client* focusedClient() = 0;
 
     // do recursive for each element of the (binary) frame tree
@@ -81,12 +105,21 @@ public: // soon will be protected:
     virtual std::shared_ptr<HSFrameSplit> isSplit() { return std::shared_ptr<HSFrameSplit>(); };
     virtual std::shared_ptr<HSFrameLeaf> isLeaf() { return std::shared_ptr<HSFrameLeaf>(); };
 protected:
+    //! compute the layout into the (empty) result, using the remembered
+    //! layout of the children
+    virtual void computeLayoutUncached(Rectangle rect, TilingResult& res) = 0;
     void foreachClient(ClientAction action);
     HSTag* tag_;
     Settings* settings_;
     std::weak_ptr<HSFrameSplit> parent_;
     Rectangle  last_rect; // last rectangle when being drawn
                           // this is only used for 'split explode'
+private:
+    // the result of the last computeLayout() and what it depended on
+    bool layoutValid_ = false;
+    Rectangle layoutRect_ = {};
+    FrameLayoutSettings layoutSettings_;
+    TilingResult layoutCache_;
 };
 
 class HSFrameLeaf : public HSFrame, public FrameDataLeaf {
@@ -96,12 +129,8 @@ public:
 
     // inherited:
     void insertClient(Client* client, bool focus = false);
-    std::shared_ptr<HSFrameLeaf> frameWithClient(Client* client) override;
-    bool removeClient(Client* client) override;
     void moveClient(int new_index);
 
-    TilingResult computeLayout(Rectangle rect) override;
-
     virtual void fmap(std::function<void(HSFrameSplit*)> onSplit,
                       std::function<void(HSFrameLeaf*)> onLeaf, int order) override;
 
@@ -116,7 +145,10 @@ public:
 
     bool split(SplitAlign alignment, int fraction, size_t childrenLeaving = 0);
     LayoutAlgorithm getLayout() { return layout; }
-    void setLayout(LayoutAlgorithm l) { layout = l; }
+    void setLayout(LayoutAlgorithm l) {
+        layout = l;
+        invalidateLayout();
+    }
     int getSelection() { return selection; }
     size_t clientCount() { return clients.size(); }
     std::shared_ptr<HSFrame> neighbour(Direction direction);
@@ -128,14 +160,24 @@ public:
     friend class HSFrame;
     void setVisible(bool visible);
     int getInnerNeighbourIndex(Direction direction);
+protected:
+    void computeLayoutUncached(Rectangle rect, TilingResult& res) override;
 private:
     friend class FrameTree;
     // layout algorithms
-    TilingResult layoutLinear(Rectangle rect, bool vertical);
-    TilingResult layoutHorizontal(Rectangle rect) { return layoutLinear(rect, false); };
-    TilingResult layoutVertical(Rectangle rect) { return layoutLinear(rect, true); };
-    TilingResult layoutMax(Rectangle rect);
-    TilingResult layoutGrid(Rectangle rect);
+    // they append the steps for the clients to the given result
+    void layoutLinear(Rectangle rect, bool vertical, TilingResult& res);
+    void layoutHorizontal(Rectangle rect, TilingResult& res) { layoutLinear(rect, false, res); };
+    void layoutVertical(Rectangle rect, TilingResult& res) { layoutLinear(rect, true, res); };
+    void layoutMax(Rectangle rect, TilingResult& res);
+    void layoutGrid(Rectangle rect, TilingResult& res);
+
+    // the index of the client in 'clients' or -1
+    int indexOf(Client* client);
+    void removeClientAt(size_t index);
+    //! point the clients from the given index on to their position here
+    void updateClientIndex(size_t from = 0);
+    void detachClient(Client* client);
 
     // members
     FrameDecoration* decoration;
@@ -147,11 +189,6 @@ public:
                  std::shared_ptr<HSFrame> a_, std::shared_ptr<HSFrame> b_);
     ~HSFrameSplit() override;
     // inherited:
-    std::shared_ptr<HSFrameLeaf> frameWithClient(Client* client) override;
-    bool removeClient(Client* client) override;
-
-    TilingResult computeLayout(Rectangle rect) override;
-
     virtual void fmap(std::function<void(HSFrameSplit*)> onSplit,
                       std::function<void(HSFrameLeaf*)> onLeaf, int order) override;
 
@@ -171,8 +208,18 @@ public:
     std::shared_ptr<HSFrameSplit> thisSplit();
     std::shared_ptr<HSFrameSplit> isSplit() override { return thisSplit(); }
     SplitAlign getAlign() { return align_; }
-    void swapSelection() { selection_ = 1 - selection_; }
-    void setSelection(int s) { selection_ = s; }
+    void swapSelection() {
+        selection_ = 1 - selection_;
+        invalidateLayout();
+    }
+    void setSelection(int s) {
+        if (selection_ != s) {
+            selection_ = s;
+            invalidateLayout();
+        }
+    }
+protected:
+    void computeLayoutUncached(Rectangle rect, TilingResult& res) override;
 private:
     friend class FrameTree;
 };
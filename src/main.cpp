@@ -16,6 +16,7 @@
 #include "frametree.h"
 #include "globals.h"
 #include "hook.h"
+#include "hookmanager.h"
 #include "ipc-protocol.h"
 #include "ipc-server.h"
 #include "keymanager.h"
@@ -23,6 +24,7 @@
 #include "monitordetection.h"
 #include "monitormanager.h"
 #include "mousemanager.h"
+#include "outputformat.h"
 #include "rectangle.h"
 #include "root.h"
 #include "rootcommands.h"
@@ -63,12 +65,14 @@ int spawn(int argc, char** argv);
 int wmexec(int argc, char** argv);
 static void remove_zombies(int signal);
 int custom_hook_emit(Input input);
+int transaction_command(Input input, Output output);
 int jumpto_command(int argc, char** argv, Output output);
 
 unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
     RootCommands* root_commands = root->root_commands.get();
 
     ClientManager* clients = root->clients();
+    HookManager* hooks = root->hooks();
     KeyManager *keys = root->keys();
     MonitorManager* monitors = root->monitors();
     MouseManager* mouse = root->mouse();
@@ -190,6 +194,10 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
                                             &RootCommands::chainCompletion}},
         {"or",             { root_commands, &RootCommands::chainCommand,
                                             &RootCommands::chainCompletion}},
+        {"transaction",    { transaction_command,
+                             [root_commands](Completion& c) {
+                                 root_commands->chainCompletion(c);
+                             }}},
         {"object_tree",    { root_commands, &RootCommands::print_object_tree_command,
                                             &RootCommands::print_object_tree_complete} },
         {"substitute",     { root_commands, &RootCommands::substitute_cmd,
@@ -212,10 +220,18 @@ unique_ptr<CommandTable> commands(shared_ptr<Root> root) {
                                             &RootCommands::getenvUnsetenvCompletion}},
         {"get_attr",       { root_commands, &RootCommands::get_attr_cmd,
                                             &RootCommands::get_attr_complete }},
+        {"get_attrs",      { root_commands, &RootCommands::get_attrs_cmd,
+                                            &RootCommands::get_attrs_complete }},
+        {"snapshot",       { root_commands, &RootCommands::snapshot_cmd,
+                                            &RootCommands::snapshot_complete }},
         {"set_attr",       { root_commands, &RootCommands::set_attr_cmd,
                                             &RootCommands::set_attr_complete }},
         {"attr",           { root_commands, &RootCommands::attr_cmd,
                                             &RootCommands::attr_complete }},
+        {"watch",          { hooks, &HookManager::watchCommand,
+                                    &HookManager::watchCompletion }},
+        {"unwatch",        { hooks, &HookManager::unwatchCommand,
+                                    &HookManager::unwatchCompletion }},
         {"mktemp",         { tmp, &Tmp::mktemp,
                                   &Tmp::mktempComplete }},
     };
@@ -252,7 +268,13 @@ int print_tag_status_command(int argc, char** argv, Output output) {
         return HERBST_INVALID_ARGUMENT;
     }
     tag_update_flags();
-    output << '\t';
+    bool json = outputFormat(output) == OutputFormat::Json;
+    JsonWriter jsonWriter(output);
+    if (json) {
+        jsonWriter.beginArray();
+    } else {
+        output << '\t';
+    }
     for (int i = 0; i < tag_get_count(); i++) {
         HSTag* tag = get_tag_by_index(i);
         // print flags
@@ -275,13 +297,31 @@ int print_tag_status_command(int argc, char** argv, Output output) {
         if (tag->flags & TAG_FLAG_URGENT) {
             c = '!';
         }
+        if (json) {
+            jsonWriter.beginObject()
+                .key("name").value(tag->name())
+                .key("status").value(string(1, c))
+                .endObject();
+            continue;
+        }
         output << c;
         output << *tag->name;
         output << '\t';
     }
+    if (json) {
+        jsonWriter.endArray();
+    }
     return 0;
 }
 
+//! run the commands like 'chain' does, but apply the relayouts and emit
+//! the hooks they cause only after the last command
+int transaction_command(Input input, Output output) {
+    HookDeferral deferHooks;
+    MonitorTransaction transaction(Root::get()->monitors());
+    return Root::get()->root_commands->chainCommand(input, output);
+}
+
 int custom_hook_emit(Input input) {
     hook_emit(input.toVector());
     return 0;
@@ -10,6 +10,7 @@
 #include "client.h"
 #include "clientmanager.h"
 #include "completion.h"
+#include "debug.h"
 #include "ewmh.h"
 #include "frametree.h"
 #include "globals.h"
@@ -51,11 +52,11 @@ Monitor::Monitor(Settings* settings_, MonitorManager* monman_, Rectangle rect_,
     , mouse { 0, 0 }
     , rect(rect_)
     , settings(settings_)
-    //, monman(monman_)
+    , monman(monman_)
 {
     for (auto i : {&pad_up, &pad_left, &pad_right, &pad_down}) {
         i->setWriteable();
-        i->changed().connect(this, &Monitor::applyLayout);
+        i->changed().connect(this, &Monitor::requestLayout);
     }
 
     stacking_window = XCreateSimpleWindow(g_display, g_root,
@@ -129,11 +130,40 @@ bool Monitor::setTag(HSTag* new_tag) {
 }
 
 void Monitor::applyLayout() {
-    if (settings->monitors_locked) {
+    monman->layoutStats().requested++;
+    performLayout();
+}
+
+void Monitor::requestLayout() {
+    LayoutStats& stats = monman->layoutStats();
+    stats.requested++;
+    if (stats.defer()) {
         dirty = true;
         return;
     }
+    performLayout();
+}
+
+void Monitor::performLayout() {
+    if (prepareLayout()) {
+        applyPreparedLayout();
+        // remove all enternotify-events from the event queue that were
+        // generated while arranging the clients on this monitor
+        drop_enternotify_events();
+    }
+}
+
+/** compute the tiling of this monitor into layoutResult_ without sending
+ * anything to the X server. Returns false if the layout has to wait
+ * because the monitors are locked.
+ */
+bool Monitor::prepareLayout() {
+    if (settings->monitors_locked || monman->inTransaction()) {
+        dirty = true;
+        return false;
+    }
     dirty = false;
+    monman->layoutStats().executed++;
     Rectangle cur_rect = rect;
     // apply pad
     // FIXME: why does the following + work for attributes pad_* ?
@@ -148,8 +178,13 @@ void Monitor::applyLayout() {
         cur_rect.height -= settings->frame_gap();
         cur_rect.width -= settings->frame_gap();
     }
-    bool isFocused = get_current_monitor() == this;
-    TilingResult res = tag->frame->root_->computeLayout(cur_rect);
+    // this reuses the memory of the previous layout
+    TilingResult& res = layoutResult_;
+    auto capacity = res.capacity();
+    res = tag->frame->root_->computeLayout(cur_rect);
+    if (res.capacity() != capacity) {
+        monman->layoutStats().bufferGrowths++;
+    }
     if (tag->floating_focused) {
         res.focus = tag->focusedClient();
     }
@@ -158,6 +193,16 @@ void Monitor::applyLayout() {
             p.second.floated = true;
         }
     }
+    return true;
+}
+
+//! move, resize and restack the windows according to prepareLayout()
+void Monitor::applyPreparedLayout() {
+    bool isFocused = get_current_monitor() == this;
+    // If the layout is applied recursively, the nested call simply starts
+    // with an empty buffer.
+    TilingResult res;
+    res.swap(layoutResult_);
     // 1. Update stack (TODO: why stack first?)
     for (auto& p : res.data) {
         Client* c = p.first;
@@ -203,21 +248,29 @@ void Monitor::applyLayout() {
     }
     restack();
     // 2. Update window geometries
+    LayoutStats& stats = monman->layoutStats();
+    auto count = [&stats](bool updated) {
+        if (updated) {
+            stats.windowsConfigured++;
+        } else {
+            stats.windowsUnchanged++;
+        }
+    };
     for (auto& p : res.data) {
         Client* c = p.first;
         if (c->fullscreen_()) {
-            c->resize_fullscreen(rect, res.focus == c && isFocused);
+            count(c->resize_fullscreen(rect, res.focus == c && isFocused));
         } else if (p.second.floated) {
-            c->resize_floating(this, res.focus == c && isFocused);
+            count(c->resize_floating(this, res.focus == c && isFocused));
         } else {
-            c->resize_tiling(p.second.geometry, res.focus == c && isFocused);
+            count(c->resize_tiling(p.second.geometry, res.focus == c && isFocused));
         }
     }
     for (auto& c : tag->floating_clients_) {
         if (c->fullscreen_()) {
-            c->resize_fullscreen(rect, res.focus == c && isFocused);
+            count(c->resize_fullscreen(rect, res.focus == c && isFocused));
         } else {
-            c->resize_floating(this, res.focus == c && isFocused);
+            count(c->resize_floating(this, res.focus == c && isFocused));
         }
     }
     if (tag->floating) {
@@ -239,10 +292,7 @@ void Monitor::applyLayout() {
             Client::window_unfocus_last();
         }
     }
-
-    // remove all enternotify-events from the event queue that were
-    // generated while arranging the clients on this monitor
-    drop_enternotify_events();
+    layoutResult_.swap(res);
 }
 
 Monitor* find_monitor_by_name(const char* name) {
@@ -396,7 +446,11 @@ Monitor* get_current_monitor() {
 }
 
 void all_monitors_apply_layout() {
-    for (auto m : *g_monitors) m->applyLayout();
+    for (auto m : *g_monitors) {
+        g_monitors->layoutStats().requested++;
+        m->dirty = true;
+    }
+    g_monitors->flushLayouts();
 }
 
 int monitor_set_tag(Monitor* monitor, HSTag* tag) {
@@ -5,6 +5,7 @@
 
 #include "attribute_.h"
 #include "object.h"
+#include "tilingresult.h"
 #include "x11-types.h"
 
 class HSTag;
@@ -52,14 +53,23 @@ public:
     int renameCommand(Input input, Output output);
     void renameComplete(Completion& complete);
     bool setTag(HSTag* new_tag);
+    //! relayout this monitor now (unless the monitors are locked)
     void applyLayout();
+    //! relayout this monitor, possibly deferred to MonitorManager::flushLayouts()
+    void requestLayout();
     void restack();
     std::string getDescription();
 private:
     std::string getTagString();
     std::string setTagString(std::string new_tag);
+    void performLayout();
+    bool prepareLayout();
+    void applyPreparedLayout();
+    friend MonitorManager;
     Settings* settings;
-    //MonitorManager* monman;
+    MonitorManager* monman;
+    //! the result of prepareLayout(), kept afterwards to reuse its memory
+    TilingResult layoutResult_;
 };
 
 // adds a new monitor to the monitors list and returns a pointer to it
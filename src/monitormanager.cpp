@@ -4,6 +4,7 @@
 #include <cassert>
 #include <memory>
 
+#include "clientmanager.h"
 #include "command.h"
 #include "completion.h"
 #include "ewmh.h"
@@ -12,11 +13,13 @@
 #include "globals.h"
 #include "ipc-protocol.h"
 #include "monitor.h"
+#include "outputformat.h"
 #include "panelmanager.h"
 #include "settings.h"
 #include "stack.h"
 #include "tag.h"
 #include "tagmanager.h"
+#include "theme.h"
 #include "utils.h"
 
 using std::endl;
@@ -43,10 +46,23 @@ MonitorManager::~MonitorManager() {
     clearChildren();
 }
 
-void MonitorManager::injectDependencies(Settings* s, TagManager* t, PanelManager* p) {
+void MonitorManager::injectDependencies(Settings* s, TagManager* t, PanelManager* p,
+                                        LayoutStats* layoutStats) {
     settings_ = s;
     tags_ = t;
     panels_ = p;
+    layoutStats_ = layoutStats;
+}
+
+void MonitorManager::connectRelayoutTriggers(ClientManager* clients, Theme* theme) {
+    relayoutTriggers_.emplace_back(
+        clients->needsRelayout.connect(this, &MonitorManager::relayoutTag));
+    relayoutTriggers_.emplace_back(
+        tags_->needsRelayout_.connect(this, &MonitorManager::relayoutTag));
+    relayoutTriggers_.emplace_back(
+        theme->theme_changed_.connect(this, &MonitorManager::relayoutAll));
+    relayoutTriggers_.emplace_back(
+        panels_->panels_changed_.connect(this, &MonitorManager::autoUpdatePads));
 }
 
 void MonitorManager::clearChildren() {
@@ -143,6 +159,27 @@ void MonitorManager::completeMonitorName(Completion& complete) {
 
 
 int MonitorManager::list_monitors(Output output) {
+    if (outputFormat(output) == OutputFormat::Json) {
+        JsonWriter json(output);
+        json.beginArray();
+        for (auto monitor : *this) {
+            json.beginObject();
+            json.key("index").value(monitor->index());
+            json.key("name").value(monitor->name());
+            json.key("geometry").beginObject()
+                .key("x").value(monitor->rect.x)
+                .key("y").value(monitor->rect.y)
+                .key("width").value(monitor->rect.width)
+                .key("height").value(monitor->rect.height)
+                .endObject();
+            json.key("tag").value(monitor->tag ? monitor->tag->name() : "");
+            json.key("focused").value(monitor == focus());
+            json.key("locked").value(monitor->lock_tag());
+            json.endObject();
+        }
+        json.endArray();
+        return 0;
+    }
     string monitor_name = "";
     int i = 0;
     for (auto monitor : *this) {
@@ -258,17 +295,44 @@ void MonitorManager::relayoutTag(HSTag* tag)
 {
     Monitor* m = byTag(tag);
     if (m) {
-        m->applyLayout();
+        m->requestLayout();
     }
 }
 
 void MonitorManager::relayoutAll()
 {
     for (Monitor* m : *this) {
-        m->applyLayout();
+        m->requestLayout();
     }
 }
 
+/** First compute the layouts of all dirty monitors, and then apply them one
+ * after the other. Since the computation does not talk to the X server,
+ * only a single round trip is needed for all monitors at the end.
+ */
+void MonitorManager::flushLayouts()
+{
+    vector<Monitor*> prepared;
+    for (Monitor* m : *this) {
+        if (m->dirty && m->prepareLayout()) {
+            prepared.push_back(m);
+        }
+    }
+    if (prepared.empty()) {
+        return;
+    }
+    for (Monitor* m : prepared) {
+        // applying the other monitors may have changed this one again
+        if (m->dirty && !m->prepareLayout()) {
+            continue;
+        }
+        m->applyPreparedLayout();
+    }
+    // remove all enternotify-events from the event queue that were
+    // generated while arranging the clients
+    drop_enternotify_events();
+}
+
 int MonitorManager::removeMonitor(Input input, Output output)
 {
     string monitorIdxString;
@@ -445,17 +509,24 @@ void MonitorManager::unlock() {
     lock_number_changed();
 }
 
+void MonitorManager::beginTransaction() {
+    transactionDepth_++;
+}
+
+void MonitorManager::commitTransaction() {
+    transactionDepth_ = std::max(0, transactionDepth_ - 1);
+    if (!inTransaction()) {
+        flushLayouts();
+    }
+}
+
 string MonitorManager::lock_number_changed() {
     if (settings_->monitors_locked() < 0) {
         return "must be non-negative";
     }
     if (!settings_->monitors_locked()) {
         // if not locked anymore, then repaint all the dirty monitors
-        for (auto m : *this) {
-            if (m->dirty) {
-                m->applyLayout();
-            }
-        }
+        flushLayouts();
     }
     return {};
 }
@@ -527,6 +598,10 @@ int MonitorManager::stackCommand(Output output) {
     }
 
     auto stackRoot = make_shared<StringTree>("", monitors);
+    if (outputFormat(output) == OutputFormat::Json) {
+        JsonWriter(output).value(stackRoot);
+        return 0;
+    }
     tree_print_to(stackRoot, output);
     return 0;
 }
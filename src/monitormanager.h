@@ -3,19 +3,24 @@
 
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "byname.h"
 #include "indexingobject.h"
 #include "link.h"
 #include "monitor.h"
 #include "plainstack.h"
+#include "signal.h"
 
 extern MonitorManager* g_monitors;
 
+class ClientManager;
 class CommandBinding;
 class Completion;
+class LayoutStats;
 class PanelManager;
 class TagManager;
+class Theme;
 class HSTag;
 class HSFrame;
 
@@ -28,7 +33,10 @@ class MonitorManager : public IndexingObject<Monitor> {
 public:
     MonitorManager();
     ~MonitorManager();
-    void injectDependencies(Settings* s, TagManager* t, PanelManager* panels);
+    void injectDependencies(Settings* s, TagManager* t, PanelManager* panels,
+                            LayoutStats* layoutStats);
+    //! relayout whenever the clients, tags, theme or panels require it
+    void connectRelayoutTriggers(ClientManager* clients, Theme* theme);
 
     Link_<Monitor> focus;
 
@@ -52,6 +60,9 @@ public:
     // relayout the monitor showing this tag, if there is any
     void relayoutTag(HSTag* tag);
     void relayoutAll();
+    //! apply all relayouts that have been deferred so far
+    void flushLayouts();
+    LayoutStats& layoutStats() { return *layoutStats_; }
     int removeMonitor(Input input, Output output);
     void removeMonitor(Monitor* monitor);
     // if the name is valid monitor name, return "", otherwise return an error message
@@ -64,6 +75,10 @@ public:
     void lock();
     void unlock();
     std::string lock_number_changed();
+    //! defer all layouts until the (outermost) transaction is committed
+    void beginTransaction();
+    void commitTransaction();
+    bool inTransaction() { return transactionDepth_ > 0; }
 
     int stackCommand(Output output);
     void extractWindowStack(bool real_clients, std::function<void(Window)> addToStack);
@@ -88,6 +103,30 @@ private:
     PanelManager* panels_;
     TagManager* tags_;
     Settings* settings_;
+    LayoutStats* layoutStats_;
+    int transactionDepth_ = 0;
+    //! the connections of the other objects' signals to this object. They
+    //are dropped along with this object, because e.g. removing the clients
+    //on shutdown still emits their signals.
+    std::vector<ScopedSignalConnection> relayoutTriggers_;
+};
+
+/** While an instance of this class exists, the given monitor manager is in
+ * a transaction, i.e. relayouts are deferred until the (outermost)
+ * transaction is committed by the destructor.
+ */
+class MonitorTransaction {
+public:
+    MonitorTransaction(MonitorManager* monitors) : monitors_(monitors) {
+        monitors_->beginTransaction();
+    }
+    ~MonitorTransaction() {
+        monitors_->commitTransaction();
+    }
+    MonitorTransaction(const MonitorTransaction&) = delete;
+    MonitorTransaction& operator=(const MonitorTransaction&) = delete;
+private:
+    MonitorManager* monitors_;
 };
 
 #endif
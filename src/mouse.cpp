@@ -51,6 +51,14 @@ MouseCombo Converter<MouseCombo>::parse(const std::string& source)
 
 template<>
 std::string Converter<MouseCombo>::str(MouseCombo payload)
+{
+    string text;
+    append(text, payload);
+    return text;
+}
+
+template<>
+void Converter<MouseCombo>::append(string& buffer, const MouseCombo& payload)
 {
     ModifiersWithString mws(payload.modifiers_, "?");
     for (const auto& p : MouseCombo::name2button) {
@@ -59,7 +67,7 @@ std::string Converter<MouseCombo>::str(MouseCombo payload)
             break;
         }
     }
-    return Converter<ModifiersWithString>::str(mws);
+    Converter<ModifiersWithString>::append(buffer, mws);
 }
 
 template<>
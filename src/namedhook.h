@@ -1,71 +1,54 @@
 #ifndef __HLWM_NAMED_HOOK_H_
 #define __HLWM_NAMED_HOOK_H_
 
-#ifdef ENABLE_NAMED_HOOK
+#include <string>
+#include <vector>
 
 #include "attribute_.h"
-#include "hook.h"
+#include "attributepath.h"
 #include "object.h"
-
-class NamedHook : public Object, public Hook {
+#include "signal.h"
+
+/** A watch on the attribute at a given path. The path is resolved anew on
+ * every check, so the watch follows e.g. 'tags.focus' to the newly focused
+ * tag. Whenever the value differs from the value seen during the previous
+ * check, the hook 'attribute_changed PATH OLDVALUE NEWVALUE' is emitted.
+ * The watch exists as long as not every 'watch' has been undone by an
+ * 'unwatch'.
+ */
+class NamedHook : public Object {
 public:
+    NamedHook(Object* root, const std::string& path);
 
-    NamedHook(const std::string &path);
-    void hook_into(Object* root);
-
-    Type type() { return Type::HOOK; }
-
-    // emit hook, used by path elements
-    void operator()(Object* sender, HookEvent event,
-                    const std::string &name);
+    //! compare the current value with the last known value
+    void check();
 
-    void trigger(const std::string &action, ArgList args);
+    std::string name() { return path_.str(); }
 
-    std::string name() { return name_; }
+    void addWatcher();
+    //! returns whether there are watchers left
+    bool removeWatcher();
 
 private:
-    /* are we listening to an object rather an attribute? If so,
-     * our complete chain is 1 element longer than the path (includes root) */
-    bool targetIsObject() { return path_.size() < chain_.size(); }
-
-    // for external trigger and called by others
-    void emit(const ArgList args);
-    // for Event::CHILD_* cases
-    void emit(HookEvent event, const std::string &name);
-    // for Event::ATTRIBUTE_CHANGED case
-    void emit(const std::string &old, const std::string &current);
-
-    // check if chain needs to be altered
-    void check_chain(std::shared_ptr<Object> sender, HookEvent event,
-                     const std::string &name);
-
-    // remove tail from chain
-    void cutoff_chain(size_t length);
-    // rebuild chain after existing elements
-    void complete_chain();
-
-    void debug_hook(std::shared_ptr<Object> sender = {},
-                    HookEvent event = HookEvent::ATTRIBUTE_CHANGED,
-                    const std::string &name = {});
-
-    std::string name_;
-    // counter attribute
-    Attribute_<int> counter_;
-    // test if hook is currently working
+    AttributePath path_;
+    Attribute_<std::string> pathAttr_;
+    // number of watch commands not undone by unwatch yet
+    Attribute_<unsigned long> watchers_;
+    // number of emitted hooks
+    Attribute_<unsigned long> counter_;
+    // whether the path currently resolves to an attribute
     Attribute_<bool> active_;
-    // external trigger for hook
-    Action emit_;
-
-    // chain of directories that report to us
-    std::vector<std::weak_ptr<Object>> chain_;
-    // tokenized path (derived from our name)
-    std::vector<std::string> path_;
-
-    // last known value, used to print new value vs. old value
-    std::string value_;
+    // last known value
+    Attribute_<std::string> value_;
+    // the current value, kept to reuse its memory
+    std::string current_;
+    // the arguments of the attribute_changed hook, kept for the same reason
+    std::vector<std::string> hookArgs_;
+    // the attribute the path resolved to in the previous check. If it
+    // announces its changes, the value is only compared after a change.
+    Attribute* attribute_ = nullptr;
+    ScopedSignalConnection attributeConnection_;
+    bool attributeChanged_ = true;
 };
 
-#endif // ENABLE_NAMED_HOOK
-
 #endif
-
@@ -9,6 +9,7 @@
 #include "attribute.h"
 #include "entity.h"
 #include "hook.h"
+#include "outputformat.h"
 #include "utils.h"
 
 using std::endl;
@@ -18,6 +19,9 @@ using std::shared_ptr;
 using std::string;
 using std::vector;
 
+unsigned long Object::treeGeneration_ = 0;
+unsigned long Object::valueGeneration_ = 0;
+
 pair<ArgList,string> Object::splitPath(const string &path) {
     vector<string> splitpath = ArgList(path, OBJECT_PATH_SEPARATOR).toVector();
     if (splitpath.empty()) {
@@ -30,6 +34,7 @@ pair<ArgList,string> Object::splitPath(const string &path) {
 
 void Object::wireAttributes(vector<Attribute*> attrs)
 {
+    treeGeneration_++;
     for (auto attr : attrs) {
         attr->setOwner(this);
         attribs_[attr->name()] = attr;
@@ -37,6 +42,7 @@ void Object::wireAttributes(vector<Attribute*> attrs)
 }
 
 void Object::addAttribute(Attribute* attr) {
+    treeGeneration_++;
     attr->setOwner(this);
     attribs_[attr->name()] = attr;
 }
@@ -45,6 +51,7 @@ void Object::removeAttribute(Attribute* attr) {
     auto it = attribs_.find(attr->name());
     if (it == attribs_.end()) return;
     if (it->second != attr) return;
+    treeGeneration_++;
     attribs_.erase(it);
 }
 
@@ -58,9 +65,25 @@ void Object::wireActions(vector<Action*> actions)
 
 void Object::ls(Output out)
 {
+    if (outputFormat(out) == OutputFormat::Json) {
+        JsonWriter json(out);
+        json.beginObject();
+        json.key("children").beginArray();
+        for (const auto& it : children_) {
+            json.value(it.first);
+        }
+        json.endArray();
+        json.key("attributes").beginObject();
+        for (const auto& it : attribs_) {
+            json.key(it.first).value(it.second);
+        }
+        json.endObject();
+        json.endObject();
+        return;
+    }
     out << children_.size() << (children_.size() == 1 ? " child" : " children")
         << (children_.size() > 0 ? ":" : ".") << endl;
-    for (auto it : children_) {
+    for (const auto& it : children_) {
         out << "  " << it.first << "." << endl;
     }
 
@@ -71,23 +94,27 @@ void Object::ls(Output out)
         << " | .-- writeable\n"
         << " | | .-- hookable\n"
         << " V V V" << endl;
-    for (auto it : attribs_) {
+    // reused for every value, so listing many attributes does not allocate
+    string value;
+    for (const auto& it : attribs_) {
         out << " " << it.second->typechar();
         out << " " << (it.second->writeable() ? "w" : "-");
         out << " " << (it.second->hookable() ? "h" : "-");
         out << " " << it.first;
+        value.clear();
+        it.second->appendStr(value);
         if (it.second->type() == Type::ATTRIBUTE_STRING
             || it.second->type() == Type::ATTRIBUTE_REGEX )
         {
-            out << " = \"" << it.second->str() << "\"" << endl;
+            out << " = \"" << value << "\"" << endl;
         } else {
-            out << " = " << it.second->str() << endl;
+            out << " = " << value << endl;
         }
     }
 
     out << actions_.size() << (actions_.size() == 1 ? " action" : " actions")
         << (actions_.size() > 0 ? ":" : ".") << endl;
-    for (auto it : actions_) {
+    for (const auto& it : actions_) {
         out << "  " << it.first << endl;
     }
 }
@@ -95,12 +122,12 @@ void Object::ls(Path path, Output out) {
     if (path.empty())
         return ls(out);
 
-    auto child = path.front();
-    if (children_.find(child) != children_.end()) {
+    auto it = children_.find(path.front());
+    if (it != children_.end()) {
         path.shift();
-        children_[child]->ls(path, out);
+        it->second->ls(path, out);
     } else {
-        out << "child " << child << " not found!" << endl; // TODO
+        out << "child " << path.front() << " not found!" << endl; // TODO
     }
 }
 
@@ -108,14 +135,14 @@ void Object::print(const string &prefix)
 {
     if (!children_.empty()) {
         std::cout << prefix << "Children:" << endl;
-        for (auto it : children_) {
+        for (const auto& it : children_) {
             it.second->print(prefix + "\t| ");
         }
         std::cout << prefix << endl;
     }
     if (!attribs_.empty()) {
         std::cout << prefix << "Attributes:" << endl;
-        for (auto it : attribs_) {
+        for (const auto& it : attribs_) {
             std::cout << prefix << "\t" << it.first
                       << " (" << it.second->typestr() << ")";
             std::cout << "\t[" << it.second->str() << "]";
@@ -129,7 +156,7 @@ void Object::print(const string &prefix)
     if (!actions_.empty()) {
         std::cout << prefix << "Actions:" << endl;
         std::cout << prefix;
-        for (auto it : actions_) {
+        for (const auto& it : actions_) {
             std::cout << "\t" << it.first;
         }
         std::cout << endl;
@@ -183,6 +210,12 @@ Object* Object::child(Path path, Output output) {
 
 void Object::notifyHooks(HookEvent event, const string& arg)
 {
+    if (event != HookEvent::ATTRIBUTE_CHANGED) {
+        // the tree structure changes, so cached paths become stale
+        treeGeneration_++;
+    } else {
+        valueGeneration_++;
+    }
     for (auto h : hooks_) {
         if (h) {
             switch (event) {
@@ -234,11 +267,11 @@ void Object::removeHook(Hook* hook)
 
 class DirectoryTreeInterface : public TreeInterface {
 public:
-    DirectoryTreeInterface(string label, Object* d) : lbl(label), dir(d) {
-        for (auto child : dir->children()) {
-            buf.push_back(child);
-        }
-    };
+    DirectoryTreeInterface(string label, Object* d)
+        : lbl(label)
+        , buf(d->children().begin(), d->children().end())
+        , dir(d)
+    { };
     size_t childCount() override {
         return buf.size();
     };
@@ -15,6 +15,7 @@
 class Attribute;
 class Action;
 class Hook;
+class JsonWriter;
 
 enum class HookEvent {
     CHILD_ADDED,
@@ -34,6 +35,10 @@ public:
     virtual void ls(Output out);
     virtual void ls(Path path, Output out); // traversial version
 
+    // write the state that is neither an attribute nor a child (e.g. the
+    // frame layout of a tag) as further keys of the object's JSON snapshot
+    virtual void snapshotExtras(JsonWriter& json) { }
+
     static std::pair<ArgList,std::string> splitPath(const std::string &path);
 
     // return an attribute if it exists, else NULL
@@ -45,7 +50,7 @@ public:
 
     void addAttribute(Attribute* a);
     void removeAttribute(Attribute* a);
-    std::map<std::string, Attribute*> attributes() { return attribs_; }
+    const std::map<std::string, Attribute*>& attributes() { return attribs_; }
 
     // if a concrete object maintains its index within the parent as an
     // attribute (e.g. monitors and tags do), then they should implement the
@@ -72,6 +77,13 @@ public:
 
     void printTree(Output output, std::string rootLabel);
 
+    //! a counter that changes whenever children or attributes are added to
+    //! or removed from any object. Used to invalidate cached lookups.
+    static unsigned long treeGeneration() { return treeGeneration_; }
+    //! a counter that changes whenever an attribute value of any object
+    //! changes. Used to invalidate cached query replies.
+    static unsigned long valueGeneration() { return valueGeneration_; }
+
 protected:
     // initialize an attribute (typically used by init())
     virtual void wireAttributes(std::vector<Attribute*> attrs);
@@ -83,6 +95,10 @@ protected:
     std::map<std::string, Object*> children_;
     std::vector<Hook*> hooks_;
 
+private:
+    static unsigned long treeGeneration_;
+    static unsigned long valueGeneration_;
+
     //DynamicAttribute nameAttribute_;
 };
 
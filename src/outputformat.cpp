@@ -0,0 +1,157 @@
+#include "outputformat.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include "attribute.h"
+#include "utils.h"
+
+using std::shared_ptr;
+using std::string;
+
+//! the index of the format in the iword array of every stream
+static int formatIndex() {
+    static int index = std::ios_base::xalloc();
+    return index;
+}
+
+OutputFormat outputFormat(Output output) {
+    return (OutputFormat)output.iword(formatIndex());
+}
+
+void setOutputFormat(Output output, OutputFormat format) {
+    output.iword(formatIndex()) = (long)format;
+}
+
+JsonWriter::JsonWriter(Output output)
+    : output_(output)
+{
+}
+
+void JsonWriter::beginValue() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (!nonEmpty_.empty()) {
+        if (nonEmpty_.back()) {
+            output_ << ',';
+        }
+        nonEmpty_.back() = true;
+    }
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    beginValue();
+    output_ << '{';
+    nonEmpty_.push_back(false);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    nonEmpty_.pop_back();
+    output_ << '}';
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    beginValue();
+    output_ << '[';
+    nonEmpty_.push_back(false);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    nonEmpty_.pop_back();
+    output_ << ']';
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const string& name) {
+    value(name);
+    output_ << ':';
+    afterKey_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const string& text) {
+    beginValue();
+    output_ << '"';
+    for (char ch : text) {
+        switch (ch) {
+            case '"': output_ << "\\\""; break;
+            case '\\': output_ << "\\\\"; break;
+            case '\n': output_ << "\\n"; break;
+            case '\t': output_ << "\\t"; break;
+            case '\r': output_ << "\\r"; break;
+            default:
+                if ((unsigned char)ch < 0x20) {
+                    // no stream manipulators, they would stick to output_
+                    char escape[8];
+                    snprintf(escape, sizeof(escape), "\\u%04x", (unsigned char)ch);
+                    output_ << escape;
+                } else {
+                    output_ << ch;
+                }
+        }
+    }
+    output_ << '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* text) {
+    return value(string(text));
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    beginValue();
+    output_ << (flag ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(int number) {
+    beginValue();
+    output_ << number;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(unsigned long number) {
+    beginValue();
+    output_ << number;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    beginValue();
+    output_ << number;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(Attribute* attribute) {
+    attributeText_.clear();
+    attribute->appendStr(attributeText_);
+    switch (attribute->type()) {
+        case Type::ATTRIBUTE_INT:
+        case Type::ATTRIBUTE_ULONG:
+        case Type::ATTRIBUTE_BOOL:
+            // their text representation is valid json already
+            beginValue();
+            output_ << attributeText_;
+            return *this;
+        default:
+            return value(attributeText_);
+    }
+}
+
+JsonWriter& JsonWriter::value(shared_ptr<TreeInterface> tree) {
+    std::ostringstream caption;
+    tree->appendCaption(caption);
+    beginObject();
+    key("caption").value(caption.str());
+    key("children").beginArray();
+    for (size_t i = 0; i < tree->childCount(); i++) {
+        value(tree->nthChild(i));
+    }
+    endArray();
+    return endObject();
+}
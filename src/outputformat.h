@@ -0,0 +1,59 @@
+#ifndef __HERBSTLUFT_OUTPUTFORMAT_H_
+#define __HERBSTLUFT_OUTPUTFORMAT_H_
+
+#include <string>
+#include <vector>
+
+#include "ipc-protocol.h"
+#include "types.h"
+
+class Attribute;
+class TreeInterface;
+
+/** The format in which a command shall print its output. The format is
+ * requested by the ipc client and is stored in the Output stream itself,
+ * such that it reaches nested commands (e.g. in 'chain') automatically.
+ * Commands that do not know about structured output just print text.
+ */
+enum class OutputFormat {
+    Text = HERBST_IPC_FORMAT_TEXT,
+    Json = HERBST_IPC_FORMAT_JSON,
+};
+
+OutputFormat outputFormat(Output output);
+void setOutputFormat(Output output, OutputFormat format);
+
+/** A minimal writer for JSON documents. The caller is responsible for
+ * nesting objects and arrays properly; the writer only takes care of the
+ * separators and of escaping strings.
+ */
+class JsonWriter {
+public:
+    JsonWriter(Output output);
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+    //! start the next member of the current object
+    JsonWriter& key(const std::string& name);
+    JsonWriter& value(const std::string& text);
+    JsonWriter& value(const char* text);
+    JsonWriter& value(bool flag);
+    JsonWriter& value(int number);
+    JsonWriter& value(unsigned long number);
+    JsonWriter& value(double number);
+    //! the value of the attribute, as a number or boolean where possible
+    JsonWriter& value(Attribute* attribute);
+    //! a tree as nested objects with a "caption" and "children"
+    JsonWriter& value(std::shared_ptr<TreeInterface> tree);
+private:
+    void beginValue();
+    Output output_;
+    //! for every open object or array, whether it already has an element
+    std::vector<bool> nonEmpty_;
+    bool afterKey_ = false;
+    //! the text of the current attribute value, kept to reuse its memory
+    std::string attributeText_;
+};
+
+#endif
@@ -15,7 +15,7 @@ public:
     RegexStr();
     //! may throw std::invalid_argument exception
     static RegexStr fromStr(const std::string& source);
-    std::string str() const { return source_; }
+    const std::string& str() const { return source_; }
     /** returns when the source is the empty string, respectivelly is 'unset'
      * (has nothing to do with the language of the regex being empty)
      */
@@ -30,6 +30,10 @@ private:
 
 template<> RegexStr Converter<RegexStr>::parse(const std::string& source);
 template<> std::string Converter<RegexStr>::str(RegexStr payload);
+template<>
+inline void Converter<RegexStr>::append(std::string& buffer, const RegexStr& payload) {
+    buffer += payload.str();
+}
 
 template<>
 inline Type Attribute_<RegexStr>::staticType() { return Type::ATTRIBUTE_REGEX; }
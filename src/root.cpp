@@ -4,6 +4,7 @@
 
 #include "client.h"
 #include "clientmanager.h"
+#include "debug.h"
 #include "ewmh.h"
 #include "hlwmcommon.h"
 #include "hookmanager.h"
@@ -26,6 +27,7 @@ shared_ptr<Root> Root::root_;
 
 Root::Root(Globals g, XConnection& xconnection, IpcServer& ipcServer)
     : clients(*this, "clients")
+    , debug(*this, "debug")
     , hooks(*this, "hooks")
     , keys(*this, "keys")
     , monitors(*this, "monitors")
@@ -44,6 +46,7 @@ Root::Root(Globals g, XConnection& xconnection, IpcServer& ipcServer)
 {
     // initialize root children (alphabetically)
     clients.init();
+    debug.init();
     hooks.init();
     keys.init();
     monitors.init();
@@ -56,10 +59,12 @@ Root::Root(Globals g, XConnection& xconnection, IpcServer& ipcServer)
 
     // inject dependencies where needed
     ewmh->injectDependencies(this);
+    hooks->injectDependencies(this);
     settings->injectDependencies(this);
     tags->injectDependencies(monitors(), settings());
     clients->injectDependencies(settings(), theme(), ewmh.get());
-    monitors->injectDependencies(settings(), tags(), panels.get());
+    monitors->injectDependencies(settings(), tags(), panels.get(),
+                                 &debug->layout);
     mouse->injectDependencies(clients(), monitors());
 
     // set temporary globals
@@ -67,13 +72,10 @@ Root::Root(Globals g, XConnection& xconnection, IpcServer& ipcServer)
     ::g_monitors = monitors();
 
     // connect slots
-    clients->needsRelayout.connect(monitors(), &MonitorManager::relayoutTag);
-    tags->needsRelayout_.connect(monitors(), &MonitorManager::relayoutTag);
+    monitors->connectRelayoutTriggers(clients(), theme());
     clients->floatingStateChanged.connect([](Client* c) {
         c->tag()->applyFloatingState(c);
     });
-    theme->theme_changed_.connect(monitors(), &MonitorManager::relayoutAll);
-    panels->panels_changed_.connect(monitors(), &MonitorManager::autoUpdatePads);
 }
 
 Root::~Root()
@@ -89,6 +91,7 @@ Root::~Root()
     tags.reset();
 
     // For the rest, order does not matter (do it alphabetically):
+    debug.reset();
     hooks.reset();
     keys.reset();
     rules.reset();
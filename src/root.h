@@ -9,6 +9,7 @@
 // new object tree root.
 
 class ClientManager;
+class Debug;
 class Ewmh;
 class HlwmCommon;
 class HookManager;
@@ -47,6 +48,7 @@ public:
 
     // (in alphabetical order)
     Child_<ClientManager> clients;
+    Child_<Debug> debug;
     Child_<HookManager> hooks;
     Child_<KeyManager> keys;
     Child_<MonitorManager> monitors;
@@ -4,18 +4,22 @@
 #include <cerrno>
 #include <cstdlib>
 #include <cstring>
+#include <fnmatch.h>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
 
 #include "attribute_.h"
+#include "attributepath.h"
 #include "command.h"
 #include "completion.h"
 #include "ipc-protocol.h"
+#include "outputformat.h"
 
 using std::endl;
 using std::function;
+using std::make_pair;
 using std::pair;
 using std::string;
 using std::stringstream;
@@ -24,19 +28,130 @@ using std::vector;
 
 extern char** environ;
 
+//! the maximal number of attribute paths remembered by getAttribute()
+static const size_t maxCachedAttributePaths = 128;
+
 RootCommands::RootCommands(Object* root_) : root(root_) {
 }
 
+RootCommands::~RootCommands() = default;
+
+//! print the value of an attribute in the requested output format
+static void printAttributeValue(Attribute* a, Output output) {
+    if (outputFormat(output) == OutputFormat::Json) {
+        JsonWriter(output).value(a);
+    } else {
+        // reused for every value, so printing does not allocate
+        static string text;
+        text.clear();
+        a->appendStr(text);
+        output << text;
+    }
+}
+
 int RootCommands::get_attr_cmd(Input in, Output output) {
     string attrName;
     if (!(in >> attrName)) return HERBST_NEED_MORE_ARGS;
 
     Attribute* a = getAttribute(attrName, output);
     if (!a) return HERBST_INVALID_ARGUMENT;
-    output << a->str();
+    printAttributeValue(a, output);
+    return 0;
+}
+
+/** print the values of several attributes at once. Every argument is either
+ * an attribute path or a glob pattern (see fnmatch(3)) that is matched
+ * against each component of the path separately. A path that can not be
+ * resolved does not abort the command but is reported along with the
+ * values.
+ */
+int RootCommands::get_attrs_cmd(Input in, Output output) {
+    if (in.empty()) return HERBST_NEED_MORE_ARGS;
+    vector<pair<string,Attribute*>> values;
+    vector<pair<string,string>> errors;
+    string path;
+    while (in >> path) {
+        if (path.find_first_of("*?[") == string::npos) {
+            std::ostringstream message;
+            Attribute* a = getAttribute(path, message);
+            if (a) {
+                values.push_back(make_pair(path, a));
+            } else {
+                string text = message.str();
+                while (!text.empty() && text.back() == '\n') {
+                    text.pop_back();
+                }
+                errors.push_back(make_pair(path, text));
+            }
+            continue;
+        }
+        auto matches = globAttributes(path);
+        if (matches.empty()) {
+            errors.push_back(make_pair(path, "No attribute matches \"" + path + "\""));
+        }
+        values.insert(values.end(), matches.begin(), matches.end());
+    }
+    if (values.empty()) {
+        // there is nothing to report but errors
+        for (const auto& e : errors) {
+            output << in.command() << ": " << e.second << endl;
+        }
+        return HERBST_INVALID_ARGUMENT;
+    }
+    if (outputFormat(output) == OutputFormat::Json) {
+        JsonWriter json(output);
+        json.beginObject();
+        json.key("values").beginObject();
+        for (const auto& v : values) {
+            json.key(v.first).value(v.second);
+        }
+        json.endObject();
+        json.key("errors").beginObject();
+        for (const auto& e : errors) {
+            json.key(e.first).value(e.second);
+        }
+        json.endObject();
+        json.endObject();
+        return 0;
+    }
+    for (const auto& v : values) {
+        output << v.first << "\t";
+        printAttributeValue(v.second, output);
+        output << endl;
+    }
+    for (const auto& e : errors) {
+        output << in.command() << ": " << e.second << endl;
+    }
     return 0;
 }
 
+vector<pair<string,Attribute*>> RootCommands::globAttributes(const string& pattern) {
+    auto split = Object::splitPath(pattern);
+    // all objects matching the object path, together with their path prefix
+    vector<pair<string,Object*>> objects = { make_pair(string(""), root) };
+    for (const auto& component : split.first) {
+        vector<pair<string,Object*>> next;
+        for (const auto& o : objects) {
+            for (const auto& child : o.second->children()) {
+                if (fnmatch(component.c_str(), child.first.c_str(), 0) == 0) {
+                    next.push_back(make_pair(o.first + child.first + OBJECT_PATH_SEPARATOR,
+                                             child.second));
+                }
+            }
+        }
+        objects.swap(next);
+    }
+    vector<pair<string,Attribute*>> matches;
+    for (const auto& o : objects) {
+        for (const auto& attr : o.second->attributes()) {
+            if (fnmatch(split.second.c_str(), attr.first.c_str(), 0) == 0) {
+                matches.push_back(make_pair(o.first + attr.first, attr.second));
+            }
+        }
+    }
+    return matches;
+}
+
 int RootCommands::set_attr_cmd(Input in, Output output) {
     string path, new_value;
     if (!(in >> path >> new_value)) return HERBST_NEED_MORE_ARGS;
@@ -74,7 +189,7 @@ int RootCommands::attr_cmd(Input in, Output output) {
     if (!a) return HERBST_INVALID_ARGUMENT;
     if (new_value.empty()) {
         // no more arguments -> return the value
-        output << a->str();
+        printAttributeValue(a, output);
         return 0;
     } else {
         // another argument -> set the value
@@ -92,27 +207,75 @@ int RootCommands::attr_cmd(Input in, Output output) {
 }
 
 Attribute* RootCommands::getAttribute(string path, Output output) {
-    auto attr_path = Object::splitPath(path);
-    auto child = root->child(attr_path.first);
-    if (!child) {
-        output << "No such object " << attr_path.first.join('.') << endl;
-        return nullptr;
+    auto it = attributePaths_.find(path);
+    if (it == attributePaths_.end()) {
+        if (attributePaths_.size() >= maxCachedAttributePaths) {
+            // the paths are not worth keeping forever, so just start over
+            attributePaths_.clear();
+        }
+        it = attributePaths_.emplace(path,
+                unique_ptr<AttributePath>(new AttributePath(root, path))).first;
     }
-    Attribute* a = child->attribute(attr_path.second);
-    if (!a) {
-        auto object_path = attr_path.first.join('.');
-        if (object_path.empty()) {
-            object_path = "The root object";
-        } else {
-            // equip object_path with quotes
-            object_path = "Object \"" + object_path + "\"";
+    return it->second->resolve(output);
+}
+
+/** print the entire object tree below the given object path as a single
+ * JSON document. An object that is reachable via several paths (e.g.
+ * tags.0 and tags.focus) is printed only once; at its other occurrences,
+ * a reference {"link": PATH} to the first path is printed instead.
+ */
+int RootCommands::snapshot_cmd(Input in, Output output) {
+    auto path = Path(in.empty() ? string("") : in.front()).toVector();
+    while (!path.empty() && path.back().empty()) {
+        path.pop_back();
+    }
+    Object* object = root->child(path, output);
+    if (!object) {
+        return HERBST_INVALID_ARGUMENT;
+    }
+    std::map<Object*, string> visited;
+    string prefix = ArgList(path).join(OBJECT_PATH_SEPARATOR);
+    visited[object] = prefix;
+    JsonWriter json(output);
+    writeSnapshot(object, prefix, visited, json);
+    output << endl;
+    return 0;
+}
+
+void RootCommands::writeSnapshot(Object* object, const string& path,
+                                 std::map<Object*, string>& visited,
+                                 JsonWriter& json)
+{
+    json.beginObject();
+    json.key("attributes").beginObject();
+    for (const auto& it : object->attributes()) {
+        json.key(it.first).value(it.second);
+    }
+    json.endObject();
+    object->snapshotExtras(json);
+    json.key("children").beginObject();
+    for (const auto& it : object->children()) {
+        json.key(it.first);
+        string childPath = path.empty() ? it.first
+                         : path + OBJECT_PATH_SEPARATOR + it.first;
+        auto seen = visited.find(it.second);
+        if (seen != visited.end()) {
+            json.beginObject().key("link").value(seen->second).endObject();
+            continue;
         }
-        output << object_path
-               << " has no attribute \"" << attr_path.second << "\""
-               << endl;
-        return nullptr;
+        visited[it.second] = childPath;
+        writeSnapshot(it.second, childPath, visited, json);
+    }
+    json.endObject();
+    json.endObject();
+}
+
+void RootCommands::snapshot_complete(Completion& complete) {
+    if (complete == 0) {
+        completeObjectPath(complete);
+    } else {
+        complete.none();
     }
-    return a;
 }
 
 int RootCommands::print_object_tree_command(Input in, Output output) {
@@ -144,8 +307,12 @@ int RootCommands::substitute_cmd(Input input, Output output)
     Attribute* a = getAttribute(path, output);
     if (!a) return HERBST_INVALID_ARGUMENT;
 
+    // the value is copied into the arguments, so the buffer can be reused
+    static string value;
+    value.clear();
+    a->appendStr(value);
     auto carryover = input.fromHere();
-    carryover.replace(ident, a->str());
+    carryover.replace(ident, value);
     return Commands::call(carryover, output);
 }
 
@@ -225,7 +392,7 @@ int RootCommands::sprintf_cmd(Input input, Output output)
             }
             Attribute* a = getAttribute(path, output);
             if (!a) return HERBST_INVALID_ARGUMENT;
-            replacedString += a->str();
+            a->appendStr(replacedString);
         }
     }
     auto carryover = input.fromHere();
@@ -480,21 +647,34 @@ void RootCommands::compare_complete(Completion &complete) {
 void RootCommands::completeObjectPath(Completion& complete, bool attributes,
                                       function<bool(Attribute*)> attributeFilter)
 {
-    ArgList objectPathArgs = std::get<0>(Object::splitPath(complete.needle()));
+    auto split = Object::splitPath(complete.needle());
+    ArgList objectPathArgs = split.first;
+    // the prefix of the name of the attribute or child
+    const string& namePrefix = split.second;
     string objectPath = objectPathArgs.join(OBJECT_PATH_SEPARATOR);
     if (objectPath != "") objectPath += OBJECT_PATH_SEPARATOR;
     Object* object = root->child(objectPathArgs);
     if (!object) return;
+    // attributes and children are sorted by name, so the matching ones
+    // form a contiguous range
     if (attributes) {
-        for (auto& it : object->attributes()) {
-            if (attributeFilter && !attributeFilter(it.second)) {
+        const auto& attribs = object->attributes();
+        for (auto it = attribs.lower_bound(namePrefix);
+             it != attribs.end() && Completion::prefixOf(namePrefix, it->first);
+             it++)
+        {
+            if (attributeFilter && !attributeFilter(it->second)) {
                 continue;
             }
-            complete.full(objectPath + it.first);
+            complete.full(objectPath + it->first);
         }
     }
-    for (auto& it : object->children()) {
-        complete.partial(objectPath + it.first + OBJECT_PATH_SEPARATOR);
+    const auto& children = object->children();
+    for (auto it = children.lower_bound(namePrefix);
+         it != children.end() && Completion::prefixOf(namePrefix, it->first);
+         it++)
+    {
+        complete.partial(objectPath + it->first + OBJECT_PATH_SEPARATOR);
     }
 }
 
@@ -507,6 +687,10 @@ void RootCommands::get_attr_complete(Completion& complete) {
     else complete.none();
 }
 
+void RootCommands::get_attrs_complete(Completion& complete) {
+    completeAttributePath(complete);
+}
+
 void RootCommands::set_attr_complete(Completion& complete) {
     if (complete == 0) {
         completeObjectPath(complete, true,
@@ -5,6 +5,7 @@
  * but modify the global state */
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -12,6 +13,8 @@
 
 class Object;
 class Attribute;
+class AttributePath;
+class JsonWriter;
 class Completion;
 
 /** this class collects high-level commands that don't need any internal
@@ -24,7 +27,10 @@ public:
      * 'root' pointer held by this class is just an Object-pointer.
      */
     RootCommands(Object* root);
+    ~RootCommands();
 
+    // look up the attribute, reusing the parsed path if this path was
+    // queried before
     Attribute* getAttribute(std::string path, Output output);
 
     /* external interface */
@@ -33,12 +39,16 @@ public:
     // is returned
     int get_attr_cmd(Input args, Output output);
     void get_attr_complete(Completion& complete);
+    int get_attrs_cmd(Input args, Output output);
+    void get_attrs_complete(Completion& complete);
     int set_attr_cmd(Input args, Output output);
     void set_attr_complete(Completion& complete);
     int attr_cmd(Input args, Output output);
     void attr_complete(Completion& complete);
     int print_object_tree_command(Input args, Output output);
     void print_object_tree_complete(Completion& complete);
+    int snapshot_cmd(Input args, Output output);
+    void snapshot_complete(Completion& complete);
 
     int substitute_cmd(Input input, Output output);
     void substitute_complete(Completion& complete);
@@ -79,6 +89,8 @@ public:
 private:
     Object* root;
     std::vector<std::unique_ptr<Attribute>> userAttributes_;
+    //! attribute paths queried via get_attr and friends, e.g. by panels
+    std::map<std::string, std::unique_ptr<AttributePath>> attributePaths_;
 
     class FormatStringBlob {
     public:
@@ -86,6 +98,10 @@ private:
         std::string data_; //! text blob or placeholder
     };
     typedef std::vector<FormatStringBlob> FormatString;
+    void writeSnapshot(Object* object, const std::string& path,
+                       std::map<Object*, std::string>& visited, JsonWriter& json);
+    //! all attributes matching the glob pattern, together with their paths
+    std::vector<std::pair<std::string,Attribute*>> globAttributes(const std::string& pattern);
     FormatString parseFormatString(const std::string& format);
 };
 
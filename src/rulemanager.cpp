@@ -5,6 +5,7 @@
 #include "completion.h"
 #include "globals.h"
 #include "ipc-protocol.h"
+#include "outputformat.h"
 #include "utils.h"
 
 using std::string;
@@ -153,6 +154,14 @@ int RuleManager::listRulesCommand(Output output) {
     return HERBST_EXIT_SUCCESS;
 }
 
+void RuleManager::snapshotExtras(JsonWriter& json) {
+    json.key("rules").beginArray();
+    for (auto& rule : rules_) {
+        rule->printJson(json);
+    }
+    json.endArray();
+}
+
 /*!
  * Removes all rules with the given label
  *
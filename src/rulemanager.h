@@ -13,6 +13,7 @@ public:
     int unruleCommand(Input input, Output output);
     void unruleCompletion(Completion& complete);
     int listRulesCommand(Output output);
+    void snapshotExtras(JsonWriter& json) override;
     ClientChanges evaluateRules(Client* client, ClientChanges inital = {});
 
 private:
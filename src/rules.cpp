@@ -6,6 +6,7 @@
 #include "client.h"
 #include "ewmh.h"
 #include "hook.h"
+#include "outputformat.h"
 #include "root.h"
 #include "utils.h"
 #include "xconnection.h"
@@ -168,6 +169,43 @@ void Rule::print(Output output) {
     output << '\n';
 }
 
+//! print the rule as a JSON object
+void Rule::printJson(JsonWriter& json) {
+    json.beginObject();
+    json.key("label").value(label);
+    json.key("once").value(once);
+    json.key("conditions").beginArray();
+    for (auto const& cond : conditions) {
+        json.beginObject();
+        json.key("name").value(cond.name);
+        json.key("negated").value(cond.negated);
+        switch (cond.value_type) {
+            case CONDITION_VALUE_TYPE_STRING:
+                json.key("operator").value("=");
+                json.key("value").value(cond.value_str);
+                break;
+            case CONDITION_VALUE_TYPE_REGEX:
+                json.key("operator").value("~");
+                json.key("value").value(cond.value_reg_str);
+                break;
+            default: /* CONDITION_VALUE_TYPE_INTEGER: */
+                json.key("operator").value("=");
+                json.key("value").value(cond.value_integer);
+        }
+        json.endObject();
+    }
+    json.endArray();
+    json.key("consequences").beginArray();
+    for (auto const& cons : consequences) {
+        json.beginObject();
+        json.key("name").value(cons.name);
+        json.key("value").value(cons.value);
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+}
+
 // rules applying //
 ClientChanges::ClientChanges()
 {
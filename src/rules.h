@@ -8,6 +8,8 @@
 #include "regexstr.h"
 #include "types.h"
 
+class JsonWriter;
+
 class Client;
 
 enum {
@@ -125,6 +127,7 @@ public:
     bool addConsequence(std::string name, char op, const char* value, Output output);
 
     void print(Output output);
+    void printJson(JsonWriter& json);
 };
 
 #endif
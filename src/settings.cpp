@@ -129,7 +129,7 @@ Settings::Settings()
         return string();
     });
     g_settings = this;
-    for (auto i : attributes()) {
+    for (const auto& i : attributes()) {
         i.second->setWriteable();
     }
 }
@@ -222,7 +222,7 @@ int Settings::set_cmd(Input input, Output output) {
 
 void Settings::set_complete(Completion& complete) {
     if (complete == 0) {
-        for (auto& a : attributes()) {
+        for (const auto& a : attributes()) {
             complete.full(a.first);
         }
     } else if (complete == 1) {
@@ -257,7 +257,7 @@ int Settings::toggle_cmd(Input argv, Output output) {
 
 void Settings::toggle_complete(Completion& complete) {
     if (complete == 0) {
-        for (auto a : attributes()) {
+        for (const auto& a : attributes()) {
             if (a.second->type() == Type::ATTRIBUTE_BOOL) {
                 complete.full(a.first);
             }
@@ -295,7 +295,7 @@ int Settings::cycle_value_cmd(Input argv, Output output) {
 
 void Settings::cycle_value_complete(Completion& complete) {
     if (complete == 0) {
-        for (auto a : attributes()) {
+        for (const auto& a : attributes()) {
             complete.full(a.first);
         }
     } else {
@@ -320,7 +320,7 @@ int Settings::get_cmd(Input argv, Output output) {
 
 void Settings::get_complete(Completion& complete) {
     if (complete == 0) {
-        for (auto& a : attributes()) {
+        for (const auto& a : attributes()) {
             complete.full(a.first);
         }
     } else if (complete == 1) {
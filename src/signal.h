@@ -1,63 +1,289 @@
 #ifndef HERBSTLUFT_SIGNAL_H
 #define HERBSTLUFT_SIGNAL_H
 
+#include<algorithm>
 #include<functional>
+#include<memory>
+#include<stdexcept>
+#include<utility>
 #include<vector>
 
+//! the common part of all slot lists, such that a connection can remove
+//! its slot without knowing the signature
+class SlotListBase {
+public:
+    virtual ~SlotListBase() = default;
+    virtual void remove(unsigned long id) = 0;
+    virtual bool contains(unsigned long id) const = 0;
+};
+
+/** the slots connected to a signal. Slots can be disconnected even while
+ * the signal is emitted; they are then skipped and removed afterwards.
+ */
+template<typename F>
+class SlotList : public SlotListBase {
+public:
+    unsigned long add(F slot) {
+        slots_.push_back(std::make_pair(nextId_, slot));
+        return nextId_++;
+    }
+    void remove(unsigned long id) override {
+        for (auto& s : slots_) {
+            if (s.first == id) {
+                s.second = nullptr;
+                removed_ = true;
+            }
+        }
+        compact();
+    }
+    bool contains(unsigned long id) const override {
+        for (const auto& s : slots_) {
+            if (s.first == id && s.second) {
+                return true;
+            }
+        }
+        return false;
+    }
+    template<typename... Args>
+    void call(const Args&... args) {
+        emitting_++;
+        // slots connected during the emission are called as well
+        for (size_t i = 0; i < slots_.size(); i++) {
+            // copy the slot, such that it survives its own disconnection
+            F slot = slots_[i].second;
+            if (slot) {
+                slot(args...);
+            }
+        }
+        emitting_--;
+        compact();
+    }
+private:
+    void compact() {
+        if (emitting_ > 0 || !removed_) {
+            return;
+        }
+        slots_.erase(std::remove_if(slots_.begin(), slots_.end(),
+                        [](const std::pair<unsigned long,F>& s) {
+                            return !s.second;
+                        }), slots_.end());
+        removed_ = false;
+    }
+    std::vector<std::pair<unsigned long,F>> slots_;
+    unsigned long nextId_ = 1;
+    int emitting_ = 0;
+    bool removed_ = false;
+};
+
+/** The handle to a connected slot, returned by Signal::connect(). It can
+ * be used to disconnect the slot again; it does not keep the signal alive.
+ */
+class SignalConnection {
+public:
+    SignalConnection() = default;
+    SignalConnection(std::weak_ptr<SlotListBase> slots, unsigned long id)
+        : slots_(slots), id_(id) {}
+    void disconnect() {
+        auto slots = slots_.lock();
+        if (slots) {
+            slots->remove(id_);
+        }
+        slots_.reset();
+    }
+    bool connected() const {
+        auto slots = slots_.lock();
+        return slots && slots->contains(id_);
+    }
+private:
+    std::weak_ptr<SlotListBase> slots_;
+    unsigned long id_ = 0;
+};
+
+//! a connection that is disconnected when the handle goes out of scope
+class ScopedSignalConnection {
+public:
+    ScopedSignalConnection() = default;
+    ScopedSignalConnection(SignalConnection connection)
+        : connection_(connection) {}
+    ScopedSignalConnection(const ScopedSignalConnection&) = delete;
+    ScopedSignalConnection& operator=(const ScopedSignalConnection&) = delete;
+    //! the moved-from handle does not disconnect anything anymore
+    ScopedSignalConnection(ScopedSignalConnection&& other)
+        : connection_(other.connection_)
+    {
+        other.connection_ = SignalConnection();
+    }
+    ScopedSignalConnection& operator=(SignalConnection connection) {
+        connection_.disconnect();
+        connection_ = connection;
+        return *this;
+    }
+    ~ScopedSignalConnection() {
+        connection_.disconnect();
+    }
+    void disconnect() { connection_.disconnect(); }
+    bool connected() const { return connection_.connected(); }
+private:
+    SignalConnection connection_;
+};
+
+/** The emissions of queued signals that still need to be delivered. The
+ * main loop calls flush() once per iteration, i.e. after each command or
+ * burst of X events.
+ */
+class SignalQueue {
+public:
+    class Entry {
+    public:
+        std::function<void()> deliver;
+        bool pending = false;
+    };
+    static void enqueue(const std::shared_ptr<Entry>& entry) {
+        if (entry->pending) {
+            return;
+        }
+        entry->pending = true;
+        queue().push_back(entry);
+    }
+    //! deliver all queued emissions, including those queued meanwhile
+    static void flush() {
+        while (!queue().empty()) {
+            std::vector<std::weak_ptr<Entry>> batch;
+            batch.swap(queue());
+            for (const auto& weakEntry : batch) {
+                auto entry = weakEntry.lock();
+                if (!entry) {
+                    // the signal does not exist anymore
+                    continue;
+                }
+                entry->pending = false;
+                entry->deliver();
+            }
+        }
+    }
+private:
+    static std::vector<std::weak_ptr<Entry>>& queue() {
+        static std::vector<std::weak_ptr<Entry>> entries;
+        return entries;
+    }
+};
+
+/** A signal calls the slots connected to it whenever it is emitted.
+ * Signals can not be copied: the slots belong to the object that owns the
+ * signal, and a queued emission is delivered by the signal itself.
+ */
 class Signal {
 public:
     Signal() = default;
+    Signal(const Signal&) = delete;
+    Signal& operator=(const Signal&) = delete;
     virtual ~Signal() = default;
 
     // connect signal to anonymous/top-level method
-    void connect(std::function<void()> slot) {
-        slots_0arg_.push_back(slot);
+    SignalConnection connect(std::function<void()> slot) {
+        auto slots = slots0arg();
+        return SignalConnection(slots, slots->add(slot));
     }
 
     // connect signal to object method
     template<typename Owner>
-    void connect(Owner* owner, void(Owner::*slot)()) {
-        slots_0arg_.push_back(std::bind(slot, owner));
+    SignalConnection connect(Owner* owner, void(Owner::*slot)()) {
+        return connect(std::function<void()>(std::bind(slot, owner)));
+    }
+
+    /** connect signal to slot. The other signal is referenced, not copied,
+     * so it also forwards to the slots connected to it later on. Hence,
+     * it has to outlive this connection or be disconnected before it is
+     * destroyed.
+     */
+    SignalConnection connect(const Signal& slot) {
+        return connect(std::function<void()>([&slot]() { slot.emit(); }));
     }
 
-    // connect signal to slot
-    void connect(const Signal& slot) {
-        slots_0arg_.push_back(std::bind(&Signal::emit, slot));
+    /** In queued mode, emit() does not call the slots right away, but the
+     * next SignalQueue::flush() does. Repeated emissions until then are
+     * delivered only once.
+     */
+    void setQueued(bool queued) {
+        if (queued && !queueEntry_) {
+            // the entry does not outlive the signal (which is not copied
+            // either), so it may refer to it
+            queueEntry_ = std::make_shared<SignalQueue::Entry>();
+            queueEntry_->deliver = [this]() { this->callSlots(); };
+        } else if (!queued) {
+            queueEntry_.reset();
+        }
     }
 
     // emit the signal
-    // instantly calls all receiving slots
+    // instantly calls all receiving slots, unless the signal is queued
     virtual void emit() const {
-        for (const auto& s : slots_0arg_) s();
+        if (queueEntry_) {
+            SignalQueue::enqueue(queueEntry_);
+        } else {
+            callSlots();
+        }
     }
 
 protected:
-    std::vector<std::function<void()>> slots_0arg_;
+    void callSlots() const {
+        if (slots0arg_) {
+            slots0arg_->call();
+        }
+    }
+    std::shared_ptr<SlotList<std::function<void()>>>& slots0arg() {
+        // allocated on demand, because most signals are never connected
+        if (!slots0arg_) {
+            slots0arg_ = std::make_shared<SlotList<std::function<void()>>>();
+        }
+        return slots0arg_;
+    }
+    std::shared_ptr<SlotList<std::function<void()>>> slots0arg_;
+    std::shared_ptr<SignalQueue::Entry> queueEntry_;
 };
 
 template<typename T>
 class Signal_ : public Signal {
 public:
     using Signal::connect;
-    void connect(std::function<void(T)> slot) {
-        slots_1arg_.push_back(slot);
+    SignalConnection connect(std::function<void(T)> slot) {
+        auto slots = slots1arg();
+        return SignalConnection(slots, slots->add(slot));
     }
     template<typename Owner>
-    void connect(Owner* owner, void(Owner::*slot)(T)) {
-        slots_1arg_.push_back(std::bind(slot, owner, std::placeholders::_1));
+    SignalConnection connect(Owner* owner, void(Owner::*slot)(T)) {
+        return connect(std::function<void(T)>(
+                    std::bind(slot, owner, std::placeholders::_1)));
     }
-    void connect(const Signal_<T>& slot) {
-        slots_1arg_.push_back([&slot](T data){ slot.emit(data); });
+    SignalConnection connect(const Signal_<T>& slot) {
+        return connect(std::function<void(T)>([&slot](T data){ slot.emit(data); }));
     }
     void emit() const override {
         throw new std::invalid_argument("emit() called without data argument");
     }
+    //! emit the signal; in queued mode, only the last data is delivered
     void emit(const T& data) const {
-        Signal::emit();
-        for (const auto& s : slots_1arg_) s(data);
+        if (queueEntry_) {
+            queueEntry_->deliver = [this, data]() { this->callSlots(data); };
+            SignalQueue::enqueue(queueEntry_);
+        } else {
+            callSlots(data);
+        }
     }
 private:
-    std::vector<std::function<void(T)>> slots_1arg_;
+    void callSlots(const T& data) const {
+        Signal::callSlots();
+        if (slots1arg_) {
+            slots1arg_->call(data);
+        }
+    }
+    std::shared_ptr<SlotList<std::function<void(T)>>>& slots1arg() {
+        if (!slots1arg_) {
+            slots1arg_ = std::make_shared<SlotList<std::function<void(T)>>>();
+        }
+        return slots1arg_;
+    }
+    std::shared_ptr<SlotList<std::function<void(T)>>> slots1arg_;
 };
 
 #endif
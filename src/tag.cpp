@@ -11,6 +11,7 @@
 #include "ipc-protocol.h"
 #include "layout.h"
 #include "monitormanager.h"
+#include "outputformat.h"
 #include "root.h"
 #include "settings.h"
 #include "stack.h"
@@ -45,6 +46,11 @@ HSTag::~HSTag() {
     frame = {};
 }
 
+void HSTag::snapshotExtras(JsonWriter& json) {
+    json.key("layout");
+    FrameTree::dumpJson(frame->root_, frame->focusedFrame(), json);
+}
+
 void HSTag::setIndexAttribute(unsigned long new_index) {
     index = new_index;
 }
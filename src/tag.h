@@ -27,6 +27,7 @@ class HSTag : public Object {
 public:
     HSTag(std::string name, TagManager* tags, Settings* settings);
     ~HSTag() override;
+    void snapshotExtras(JsonWriter& json) override;
     std::shared_ptr<FrameTree>        frame;  // the master frame
     Attribute_<unsigned long> index;
     Attribute_<bool>         floating;
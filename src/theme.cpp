@@ -4,6 +4,9 @@ using std::vector;
 using std::string;
 
 Theme::Theme() {
+    // changing many theme attributes at once (e.g. via theme.reset) shall
+    // only trigger a single relayout
+    theme_changed_.setQueued(true);
     // add sub-decorations array as children
     vector<string> type_names = {
         "fullscreen",
@@ -44,7 +47,10 @@ DecorationScheme::DecorationScheme()
     for (auto i : proxyAttributes_) {
         addAttribute(i->toAttribute());
         i->toAttribute()->setWriteable();
-        i->toAttribute()->changed().connect([this]() { this->scheme_changed_.emit(); });
+        i->toAttribute()->changed().connect([this]() {
+            this->generation_++;
+            this->scheme_changed_.emit();
+        });
     }
 }
 
@@ -67,7 +73,7 @@ DecTriple::DecTriple()
 //! reset all attributes to a default value
 string DecorationScheme::resetSetterHelper(string)
 {
-    for (auto it : attributes()) {
+    for (const auto& it : attributes()) {
         it.second->resetValue();
     }
     return {};
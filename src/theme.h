@@ -89,6 +89,8 @@ public:
     AttributeProxy_<Color>   background_color = {"background_color", {"black"}}; // color behind client contents
 
     Signal scheme_changed_; //! whenever one of the attributes changes.
+    //! increased on every change of the attributes
+    unsigned long generation() const { return generation_; }
 
     Rectangle inner_rect_to_outline(Rectangle rect) const;
     Rectangle outline_to_inner_rect(Rectangle rect) const;
@@ -101,6 +103,7 @@ private:
     std::string resetSetterHelper(std::string dummy);
     std::string resetGetterHelper();
     std::vector<ProxyAddTargetInterface*> proxyAttributes_;
+    unsigned long generation_ = 0;
 };
 
 class DecTriple : public DecorationScheme {
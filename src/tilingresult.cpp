@@ -1,20 +1,40 @@
 #include "tilingresult.h"
 
 using std::make_pair;
+using std::pair;
 
 TilingStep::TilingStep(Rectangle rect)
     : geometry(rect)
 { }
 
 TilingStep& TilingResult::operator[](Client* client) {
-    TilingStep someStep = Rectangle();
-    data.push_back(make_pair(client, someStep));
-    return data.rbegin()->second;
+    data.push_back(make_pair(client, TilingStep(Rectangle())));
+    return data.back().second;
 }
 
-void TilingResult::mergeFrom(TilingResult& other) {
-    data.splice(data.end(), other.data);
-    frames.splice(frames.end(), other.frames);
+void TilingResult::appendFrom(const TilingResult& other) {
+    data.insert(data.end(), other.data.begin(), other.data.end());
+    frames.insert(frames.end(), other.frames.begin(), other.frames.end());
+}
+
+void TilingResult::clear() {
+    data.clear();
+    frames.clear();
+    focus = {};
+    focused_frame = {};
+}
+
+void TilingResult::swap(TilingResult& other) {
+    data.swap(other.data);
+    frames.swap(other.frames);
+    // the member swap() would hide it otherwise
+    using std::swap;
+    swap(focus, other.focus);
+    swap(focused_frame, other.focused_frame);
+}
+
+pair<size_t,size_t> TilingResult::capacity() const {
+    return make_pair(data.capacity(), frames.capacity());
 }
 
 void TilingResult::add(FrameDecoration* dec, const FrameDecorationData& frame_data) {
@@ -1,7 +1,8 @@
 #ifndef __HLWM_TILINGSTEP_H_
 #define __HLWM_TILINGSTEP_H_
 
-#include <list>
+#include <utility>
+#include <vector>
 
 #include "framedecoration.h"
 #include "x11-types.h"
@@ -18,7 +19,10 @@ public:
     bool needsRaise = false;
 };
 
-// a tiling result contains the movement commands etc. for all clients
+/** a tiling result contains the movement commands etc. for all clients.
+ * The steps are stored contiguously, and clear() keeps the memory, such
+ * that a result that is filled repeatedly does not allocate anymore.
+ */
 class TilingResult {
 public:
     TilingResult() = default;
@@ -28,11 +32,16 @@ public:
     Client* focus = {}; // the focused client
     FrameDecoration* focused_frame = {};
 
-    // merge all the tiling steps from other into this
-    void mergeFrom(TilingResult& other);
+    // append all the tiling steps from other to this
+    void appendFrom(const TilingResult& other);
+    // remove all steps, but keep the memory
+    void clear();
+    void swap(TilingResult& other);
+    //! the number of steps and frames that fit without allocating memory
+    std::pair<size_t,size_t> capacity() const;
 
-    std::list<std::pair<FrameDecoration*,FrameDecorationData>> frames;
-    std::list<std::pair<Client*,TilingStep>> data;
+    std::vector<std::pair<FrameDecoration*,FrameDecorationData>> frames;
+    std::vector<std::pair<Client*,TilingStep>> data;
 };
 
 
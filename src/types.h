@@ -1,8 +1,10 @@
 #ifndef HERBSTLUFT_TYPES_H
 #define HERBSTLUFT_TYPES_H
 
+#include <cstdio>
 #include <map>
 #include <set>
+#include <string>
 
 #include "arglist.h"
 
@@ -77,6 +79,14 @@ struct Converter {
     /** Return a user-friendly string representation */
     static std::string str(T payload) { return std::to_string(payload); }
 
+    /** Append the representation of str() to the buffer. Specializations
+     * write into the buffer directly, such that a buffer that is reused
+     * for many values does not need any new memory.
+     */
+    static void append(std::string& buffer, const T& payload) {
+        buffer += str(payload);
+    }
+
     /** Give possible completion values. The completion can be relative to 'relativeTo', e.g.
      * "toggle" in booleans will be proposed only if relativeTo is present
      */
@@ -90,6 +100,7 @@ struct Converter {
 #define ConverterInstance(T) \
     template<> T Converter<T>::parse(const std::string& source); \
     template<> std::string Converter<T>::str(T payload); \
+    template<> void Converter<T>::append(std::string& buffer, const T& payload); \
     template<> void Converter<T>::complete(Completion& complete, T const* relativeTo);
 
 // Integers
@@ -99,6 +110,17 @@ inline int Converter<int>::parse(const std::string &payload) {
 }
 template<>
 unsigned long Converter<unsigned long>::parse(const std::string &payload);
+template<>
+inline void Converter<int>::append(std::string& buffer, const int& payload) {
+    char digits[16];
+    buffer.append(digits, snprintf(digits, sizeof(digits), "%d", payload));
+}
+template<>
+inline void Converter<unsigned long>::append(std::string& buffer,
+                                             const unsigned long& payload) {
+    char digits[24];
+    buffer.append(digits, snprintf(digits, sizeof(digits), "%lu", payload));
+}
 
 // Booleans
 template<>
@@ -106,6 +128,10 @@ inline std::string Converter<bool>::str(bool payload) {
     return { payload ? "true" : "false" };
 }
 template<>
+inline void Converter<bool>::append(std::string& buffer, const bool& payload) {
+    buffer += payload ? "true" : "false";
+}
+template<>
 inline bool Converter<bool>::parse(const std::string &payload) {
     std::set<std::string> t = {"true", "on", "1"};
     std::set<std::string> f = {"false", "off", "0"};
@@ -132,6 +158,11 @@ template<> void Converter<bool>::complete(Completion& complete, bool const* rela
 template<>
 inline std::string Converter<std::string>::str(std::string payload) { return payload; }
 template<>
+inline void Converter<std::string>::append(std::string& buffer,
+                                           const std::string& payload) {
+    buffer += payload;
+}
+template<>
 inline std::string Converter<std::string>::parse(const std::string &payload) {
     return payload;
 }
@@ -5,7 +5,6 @@
 #include <X11/Xutil.h>
 #include <algorithm>
 #include <cassert>
-#include <iomanip>
 
 #include "globals.h"
 
@@ -37,14 +36,18 @@ Color::Color(string name) {
 }
 
 string Color::str() const {
+    string text;
+    appendTo(text);
+    return text;
+}
+
+void Color::appendTo(string& buffer) const {
     unsigned long divisor =  (65536 + 1) / (0xFF + 1);
-    std::stringstream ss;
-    ss << "#"
-       << std::hex << std::setfill('0') << std::setw(2) << (red_ / divisor)
-       << std::hex << std::setfill('0') << std::setw(2) << (green_ / divisor)
-       << std::hex << std::setfill('0') << std::setw(2) << (blue_ / divisor)
-    ;
-    return ss.str();
+    char text[8];
+    buffer.append(text, snprintf(text, sizeof(text), "#%02lx%02lx%02lx",
+                                 red_ / divisor,
+                                 green_ / divisor,
+                                 blue_ / divisor));
 }
 
 Color Color::fromStr(const string& payload) {
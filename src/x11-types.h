@@ -19,6 +19,8 @@ public:
     // throws std::invalid_argument
     static Color fromStr(const std::string& payload);
     std::string str() const;
+    //! append str() to the buffer
+    void appendTo(std::string& buffer) const;
 
     // return an XColor as obtained form XQueryColor
     XColor toXColor() const;
@@ -48,6 +50,10 @@ private:
 
 template<>
 inline std::string Converter<Color>::str(Color payload) { return payload.str(); }
+template<>
+inline void Converter<Color>::append(std::string& buffer, const Color& payload) {
+    payload.appendTo(buffer);
+}
 
 template<>
 inline Color Converter<Color>::parse(const std::string &payload) {
@@ -97,11 +103,20 @@ struct Rectangle {
 };
 std::ostream& operator<< (std::ostream& stream, const Rectangle& matrix);
 
+template<>
+inline void Converter<Rectangle>::append(std::string& buffer,
+                                         const Rectangle& payload) {
+    // the same as operator<<
+    char text[64];
+    buffer.append(text, snprintf(text, sizeof(text), "%dx%d%+d%+d",
+                                 payload.width, payload.height,
+                                 payload.x, payload.y));
+}
 template<>
 inline std::string Converter<Rectangle>::str(Rectangle payload) {
-    std::stringstream ss;
-    ss << payload;
-    return ss.str();
+    std::string text;
+    append(text, payload);
+    return text;
 }
 
 template<>
@@ -119,9 +134,13 @@ public:
     WindowID(Window w) : value_(w) { }
     inline Window operator()() const { return value_; }
     inline std::string str() const {
-        std::stringstream ss;
-        ss << "0x" << std::hex << value_;
-        return ss.str();
+        std::string text;
+        appendTo(text);
+        return text;
+    }
+    inline void appendTo(std::string& buffer) const {
+        char text[24];
+        buffer.append(text, snprintf(text, sizeof(text), "0x%lx", value_));
     }
     operator Window() const { return value_; }
 private:
@@ -135,6 +154,11 @@ template<>
 inline std::string Converter<WindowID>::str(WindowID payload) {
     return payload.str();
 }
+template<>
+inline void Converter<WindowID>::append(std::string& buffer,
+                                        const WindowID& payload) {
+    payload.appendTo(buffer);
+}
 
 template<>
 inline WindowID Converter<WindowID>::parse(const std::string &payload) {
@@ -4,6 +4,7 @@
 #include <X11/XKBlib.h>
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
+#include <algorithm>
 
 #include "globals.h"
 
@@ -86,8 +87,20 @@ void XKeyGrabber::changeGrabbedState(const KeyCombo& keyCombo, bool grabbed) {
     }
 }
 
-vector<string> XKeyGrabber::getPossibleKeySyms() {
-    vector<string> ret;
+vector<string> XKeyGrabber::possibleKeySyms_;
+bool XKeyGrabber::possibleKeySymsValid_ = false;
+
+/*!
+ * Returns the keysyms that can be typed on the current keyboard mapping.
+ * They are only queried from the X server after the mapping has changed,
+ * and they are kept sorted such that completion can look up a prefix by
+ * binary search.
+ */
+const vector<string>& XKeyGrabber::getPossibleKeySyms() {
+    if (possibleKeySymsValid_) {
+        return possibleKeySyms_;
+    }
+    possibleKeySyms_.clear();
     int min, max;
     XDisplayKeycodes(g_display, &min, &max);
     int kc_count = max - min + 1;
@@ -100,10 +113,15 @@ vector<string> XKeyGrabber::getPossibleKeySyms() {
     for (int i = 0; i < kc_count; i++) {
         if (keysyms[i * ks_per_kc] != NoSymbol) {
             char* str = XKeysymToString(keysyms[i * ks_per_kc]);
-            ret.push_back(str);
+            possibleKeySyms_.push_back(str);
         }
     }
     XFree(keysyms);
+    std::sort(possibleKeySyms_.begin(), possibleKeySyms_.end());
+    possibleKeySymsValid_ = true;
+    return possibleKeySyms_;
+}
 
-    return ret;
+void XKeyGrabber::keyboardMappingChanged() {
+    possibleKeySymsValid_ = false;
 }
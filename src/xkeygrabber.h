@@ -31,11 +31,17 @@ public:
         return numlockMask_;
     }
 
-    static std::vector<std::string> getPossibleKeySyms();
+    //! the keysyms of the current keyboard mapping, in sorted order
+    static const std::vector<std::string>& getPossibleKeySyms();
+    //! forget the keysyms, such that they are queried again
+    static void keyboardMappingChanged();
 
 private:
     void changeGrabbedState(const KeyCombo& keyCombo, bool grabbed);
     unsigned int numlockMask_ = 0;
 
+    static std::vector<std::string> possibleKeySyms_;
+    static bool possibleKeySymsValid_;
+
 };
 
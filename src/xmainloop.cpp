@@ -3,15 +3,22 @@
 #include <X11/X.h>
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
+#include <poll.h>
+#include <chrono>
+#include <deque>
 #include <iostream>
+#include <map>
 #include <memory>
 
 #include "client.h"
 #include "clientmanager.h"
+#include "debug.h"
+#include "decoration.h"
 #include "desktopwindow.h"
 #include "ewmh.h"
 #include "frametree.h"
 #include "hlwmcommon.h"
+#include "hookmanager.h"
 #include "ipc-server.h"
 #include "keymanager.h"
 #include "layout.h"
@@ -22,13 +29,21 @@
 #include "root.h"
 #include "rules.h"
 #include "settings.h"
+#include "signal.h"
 #include "tag.h"
 #include "tagmanager.h"
 #include "utils.h"
 #include "xconnection.h"
+#include "xkeygrabber.h"
 
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
 using std::function;
+using std::pair;
 using std::shared_ptr;
+using std::string;
+using std::vector;
 
 /** A custom event handler casting function.
  *
@@ -142,29 +157,272 @@ void XMainLoop::scanExistingClients() {
 }
 
 
-void XMainLoop::run() {
+/** dispatch all events that are available without blocking. In contrast to
+ * XSync(), XPending() only flushes the output buffer and reads what is there,
+ * but does not wait for a round trip.
+ */
+void XMainLoop::dispatchQueuedEvents() {
     XEvent event;
-    int x11_fd;
-    fd_set in_fds;
-    x11_fd = ConnectionNumber(X_.display());
+    MainLoopStats& stats = root_->debug->mainloop;
+    EventStats& eventStats = root_->debug->events;
+    while (XPending(X_.display())) {
+        XNextEvent(X_.display(), &event);
+        if (isSuperseded(&event)) {
+            continue;
+        }
+        EventHandler handler = handlerTable_[event.type];
+        if (handler != nullptr && eventStats.enabled()) {
+            auto start = steady_clock::now();
+            (this ->* handler)(&event);
+            auto duration = duration_cast<microseconds>(steady_clock::now() - start);
+            eventStats.record(event.type, duration.count());
+        } else if (handler != nullptr) {
+            (this ->* handler)(&event);
+        }
+        HlwmCommon::invalidateQueries();
+        stats.events++;
+        // formerly, every event was followed by a XSync()
+        stats.roundtripsSaved++;
+    }
+}
+
+void XMainLoop::run() {
+    int x11_fd = ConnectionNumber(X_.display());
+    vector<int> ipcReadFds;
+    vector<int> ipcWriteFds;
+    vector<struct pollfd> pollFds;
+    MainLoopStats& stats = root_->debug->mainloop;
     while (!aboutToQuit_) {
-        FD_ZERO(&in_fds);
-        FD_SET(x11_fd, &in_fds);
-        // wait for an event or a signal
-        select(x11_fd + 1, &in_fds, nullptr, nullptr, nullptr);
+        dispatchQueuedEvents();
         if (aboutToQuit_) {
             break;
         }
-        XSync(X_.display(), False);
-        while (XQLength(X_.display())) {
-            XNextEvent(X_.display(), &event);
-            EventHandler handler = handlerTable_[event.type];
-            if (handler != nullptr) {
-                (this ->* handler)(&event);
+        if (root_->ipcServer_.hasPendingCalls()) {
+            // continue with the calls that were postponed in favour of the
+            // X events we have just handled
+            root_->ipcServer_.handlePendingCalls(HlwmCommon::callCommand);
+        }
+        // deliver the queued signals and relayout everything the events
+        // and calls have requested
+        SignalQueue::flush();
+        root_->monitors->flushLayouts();
+        // announce the attribute values that have changed meanwhile
+        root_->hooks->checkWatches();
+        if (root_->ipcServer_.hasNewReplies()) {
+            // when a client receives a reply or a hook, the X server shall
+            // already have processed everything that happened before.
+            XSync(X_.display(), False);
+            stats.roundtrips++;
+            root_->ipcServer_.flushReplies();
+            if (QLength(X_.display()) > 0) {
+                // the round trip has queued further events, and poll()
+                // would not notice them
+                continue;
             }
+        }
+        // send the requests of the relayouts and the hooks emitted by
+        // checkWatches() (property protocol listeners would not see them
+        // otherwise), and handle the events that the round trip of the
+        // relayouts (see drop_enternotify_events()) has already read into
+        // Xlib's queue, because poll() would not notice them
+        XFlush(X_.display());
+        if (QLength(X_.display()) > 0) {
+            continue;
+        }
+        pollFds.clear();
+        pollFds.push_back({x11_fd, POLLIN, 0});
+        root_->ipcServer_.socketFds(ipcReadFds, ipcWriteFds);
+        for (int fd : ipcReadFds) {
+            pollFds.push_back({fd, POLLIN, 0});
+        }
+        for (int fd : ipcWriteFds) {
+            pollFds.push_back({fd, POLLOUT, 0});
+        }
+        // wait for an event, an ipc call or a signal, unless there are
+        // postponed calls left
+        stats.iterations++;
+        int timeout = root_->ipcServer_.hasPendingCalls() ? 0 : -1;
+        if (poll(pollFds.data(), pollFds.size(), timeout) < 0) {
+            // interrupted by a signal
+            continue;
+        }
+        if (aboutToQuit_) {
+            break;
+        }
+        bool ipcCalls = false;
+        for (size_t i = 1; i < pollFds.size(); i++) {
+            ipcCalls = ipcCalls || (pollFds[i].revents & POLLIN);
+        }
+        if (ipcCalls) {
+            // With the property protocol, the X server puts the call in line
+            // with all other events. So to give the same guarantees, process
+            // everything the X server has sent before the call arrived.
             XSync(X_.display(), False);
+            stats.roundtrips++;
+            dispatchQueuedEvents();
+        } else {
+            // formerly, the main loop synced after every wakeup
+            stats.roundtripsSaved++;
+        }
+        for (size_t i = 1; i < pollFds.size(); i++) {
+            short revents = pollFds[i].revents;
+            if (revents == 0) {
+                continue;
+            }
+            // a hang up or error is noticed when reading
+            bool readable = 0 != (revents & (POLLIN | POLLHUP | POLLERR));
+            bool writable = 0 != (revents & POLLOUT);
+            root_->ipcServer_.handleSocket(pollFds[i].fd, readable, writable,
+                                           HlwmCommon::callCommand);
+        }
+    }
+}
+
+/** run a command received via the property protocol. Its reply is sent
+ * immediately, so apply the relayouts the command has requested first.
+ */
+pair<int,string> XMainLoop::callCommand(const vector<string>& call,
+                                        OutputFormat format) {
+    auto result = HlwmCommon::callCommand(call, format);
+    SignalQueue::flush();
+    root_->monitors->flushLayouts();
+    return result;
+}
+
+/** The kind of event and what it refers to. Of two events with the same
+ * key, the later one makes the earlier one obsolete (for configure
+ * requests, only if it also sets all values of the earlier one).
+ */
+static XMainLoop::CoalescingKey coalescingKey(const XEvent* ev) {
+    switch (ev->type) {
+        case MotionNotify:
+            return XMainLoop::CoalescingKey(ev->type, ev->xmotion.window, None, 0);
+        case PropertyNotify:
+            return XMainLoop::CoalescingKey(ev->type, ev->xproperty.window,
+                                            ev->xproperty.atom, ev->xproperty.state);
+        case ConfigureRequest:
+            return XMainLoop::CoalescingKey(ev->type, ev->xconfigurerequest.window, None, 0);
+        case EnterNotify:
+            return XMainLoop::CoalescingKey(ev->type, ev->xcrossing.window, None, 0);
+    }
+    return XMainLoop::CoalescingKey(ev->type, None, None, 0);
+}
+
+//! whether the two events with the same key are (most likely) the same
+static bool sameEvent(const XEvent& a, const XEvent& b) {
+    if (a.xany.serial != b.xany.serial) {
+        return false;
+    }
+    switch (a.type) {
+        case MotionNotify:
+            return a.xmotion.time == b.xmotion.time
+                && a.xmotion.x_root == b.xmotion.x_root
+                && a.xmotion.y_root == b.xmotion.y_root;
+        case PropertyNotify:
+            return a.xproperty.time == b.xproperty.time;
+        case ConfigureRequest: {
+            const XConfigureRequestEvent& x = a.xconfigurerequest;
+            const XConfigureRequestEvent& y = b.xconfigurerequest;
+            return x.value_mask == y.value_mask
+                && x.x == y.x && x.y == y.y
+                && x.width == y.width && x.height == y.height
+                && x.border_width == y.border_width
+                && x.above == y.above && x.detail == y.detail;
         }
+        case EnterNotify:
+            return a.xcrossing.time == b.xcrossing.time;
     }
+    return true;
+}
+
+//! the coalescing counter for the event, or nullptr if it is never dropped
+static unsigned long* coalescingCounter(EventCoalescing& rules, const XEvent* event) {
+    switch (event->type) {
+        case MotionNotify:
+            return rules.motion() ? &rules.motionMerged : nullptr;
+        case PropertyNotify:
+            return rules.property() ? &rules.propertyMerged : nullptr;
+        case ConfigureRequest:
+            return rules.configureRequest() ? &rules.configureRequestMerged : nullptr;
+        case EnterNotify:
+            return rules.enter() ? &rules.enterMerged : nullptr;
+    }
+    return nullptr;
+}
+
+//! the state when indexing the event queue
+struct QueueScan {
+    EventCoalescing* rules;
+    std::map<XMainLoop::CoalescingKey, std::deque<XEvent>>* queued;
+};
+
+/** A predicate for XCheckIfEvent() that never matches, but adds every
+ * event that may be dropped to the index.
+ */
+static Bool indexQueuedEvent(Display*, XEvent* ev, XPointer arg) {
+    QueueScan* scan = (QueueScan*)arg;
+    if (coalescingCounter(*scan->rules, ev)) {
+        (*scan->queued)[coalescingKey(ev)].push_back(*ev);
+    }
+    return False;
+}
+
+//! index all events in Xlib's queue by their coalescing key
+void XMainLoop::indexQueuedEvents() {
+    queuedEvents_.clear();
+    QueueScan scan = { &root_->debug->coalescing, &queuedEvents_ };
+    XEvent dummy;
+    XCheckIfEvent(X_.display(), &dummy, indexQueuedEvent, (XPointer)&scan);
+}
+
+/** Return whether the event can be dropped because a later event that is
+ * already queued has the same effect. The queue itself is not modified.
+ *
+ * Instead of searching the queue for every event, the queue is indexed
+ * once per burst. The index stays valid as long as the dequeued events
+ * are the ones it knows: events are only appended to the queue, and the
+ * event handlers that remove events always remove all events of a type,
+ * i.e. also the event that is dequeued next. Any other event makes the
+ * index be built anew.
+ */
+bool XMainLoop::isSuperseded(XEvent* event) {
+    unsigned long* counter = coalescingCounter(root_->debug->coalescing, event);
+    if (!counter) {
+        return false;
+    }
+    auto key = coalescingKey(event);
+    auto it = queuedEvents_.find(key);
+    if (it != queuedEvents_.end() && !it->second.empty()
+        && sameEvent(it->second.front(), *event))
+    {
+        it->second.pop_front();
+    } else {
+        // the event has been queued after the index was built. Since the
+        // event is not in the queue anymore, the new index only contains
+        // later events.
+        indexQueuedEvents();
+        it = queuedEvents_.find(key);
+    }
+    if (it == queuedEvents_.end()) {
+        return false;
+    }
+    bool found = false;
+    if (event->type == ConfigureRequest) {
+        // only if a later request overwrites all values of this one
+        for (const auto& later : it->second) {
+            if (0 == (event->xconfigurerequest.value_mask
+                      & ~later.xconfigurerequest.value_mask)) {
+                found = true;
+                break;
+            }
+        }
+    } else {
+        found = !it->second.empty();
+    }
+    if (found) {
+        (*counter)++;
+    }
+    return found;
 }
 
 void XMainLoop::quit() {
@@ -199,7 +457,9 @@ void XMainLoop::createnotify(XCreateWindowEvent* event) {
     if (root_->ipcServer_.isConnectable(event->window)) {
         root_->ipcServer_.addConnection(event->window);
         root_->ipcServer_.handleConnection(event->window,
-                                           HlwmCommon::callCommand);
+            [this](const vector<string>& call, OutputFormat format) {
+                return callCommand(call, format);
+            });
     }
 }
 
@@ -245,6 +505,8 @@ void XMainLoop::configurerequest(XConfigureRequestEvent* cre) {
             if (width_requested) newRect.width = cre->width;
             if (height_requested) newRect.height = cre->height;
         }
+        Rectangle oldInner = client->dec->last_inner();
+        Rectangle oldOuter = client->dec->last_outer();
         if (changes && client->is_client_floated()) {
             client->float_size_ = newRect;
             client->resize_floating(find_monitor_with_tag(client->tag()), client == get_current_client());
@@ -252,8 +514,14 @@ void XMainLoop::configurerequest(XConfigureRequestEvent* cre) {
             client->float_size_ = newRect;
             Monitor* m = find_monitor_with_tag(client->tag());
             if (m) m->applyLayout();
-        } else {
-        // FIXME: why send event and not XConfigureWindow or XMoveResizeWindow??
+        }
+        if (oldInner == client->dec->last_inner()
+            && oldOuter == client->dec->last_outer())
+        {
+            // the windows were not touched, e.g. because the request
+            // resolved to the current geometry. Still, the client expects
+            // a ConfigureNotify.
+            // FIXME: why send event and not XConfigureWindow or XMoveResizeWindow??
             client->send_configure();
         }
     } else {
@@ -338,6 +606,7 @@ void XMainLoop::mappingnotify(XMappingEvent* ev) {
     // regrab when keyboard map changes
     XRefreshKeyboardMapping(ev);
     if(ev->request == MappingKeyboard) {
+        XKeyGrabber::keyboardMappingChanged();
         root_->keys()->regrabAll();
         //TODO: mouse_regrab_all();
     }
@@ -414,7 +683,9 @@ void XMainLoop::propertynotify(XPropertyEvent* ev) {
     if (ev->state == PropertyNewValue) {
         if (root_->ipcServer_.isConnectable(ev->window)) {
             root_->ipcServer_.handleConnection(ev->window,
-                                               HlwmCommon::callCommand);
+                [this](const vector<string>& call, OutputFormat format) {
+                    return callCommand(call, format);
+                });
         } else if (client != nullptr) {
             //char* atomname = XGetAtomName(X_.display(), ev->atom);
             //HSDebug("Property notify for client %s: atom %d \"%s\"\n",
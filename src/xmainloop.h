@@ -2,6 +2,14 @@
 
 #include <X11/X.h>
 #include <X11/Xlib.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "outputformat.h"
 
 class Root;
 class XConnection;
@@ -14,12 +22,21 @@ public:
     //! quit the main loop as soon as possible
     void quit();
     using EventHandler = void (XMainLoop::*)(XEvent*);
+    //! event type, window, property atom and property state
+    using CoalescingKey = std::tuple<int, Window, Atom, int>;
 private:
     // members
     XConnection& X_;
     Root* root_;
     bool aboutToQuit_;
     EventHandler handlerTable_[LASTEvent];
+    void dispatchQueuedEvents();
+    bool isSuperseded(XEvent* event);
+    void indexQueuedEvents();
+    //! the events queued in Xlib that may be dropped, by their key
+    std::map<CoalescingKey, std::deque<XEvent>> queuedEvents_;
+    std::pair<int,std::string> callCommand(const std::vector<std::string>& call,
+                                           OutputFormat format);
     // event handlers
     void buttonpress(XButtonEvent* event);
     void buttonrelease(XButtonEvent* event);
@@ -50,3 +50,23 @@ def test_focus_follows_mouse(hlwm, mouse, focus_follows_mouse, single_floating):
     assert c1_is_focused == focus_follows_mouse
     # stacking is unchanged
     assert test_stack.helper_get_stack_as_list(hlwm) == [c2, c1]
+
+
+@pytest.mark.parametrize("coalesce", [True, False])
+def test_title_burst_with_coalescing(hlwm, x11, coalesce):
+    hlwm.call(['set_attr', 'debug.coalescing.property', hlwm.bool(coalesce)])
+    win, winid = x11.create_client()
+    merged_before = int(hlwm.get_attr('debug.coalescing.property_merged'))
+
+    # the changes are sent at once, so they arrive as one burst
+    for i in range(100):
+        win.set_wm_name(f'title {i}')
+    x11.display.sync()
+    x11.sync_with_hlwm()
+
+    assert hlwm.get_attr(f'clients.{winid}.title') == 'title 99'
+    merged = int(hlwm.get_attr('debug.coalescing.property_merged')) - merged_before
+    if coalesce:
+        assert merged > 0
+    else:
+        assert merged == 0
@@ -230,3 +230,27 @@ def test_posix_escape(hlwm):
     results = hlwm.complete(['use'], evaluate_escapes=True)
     print(results)
     assert sorted(['default'] + tags) == sorted(results)
+
+
+@pytest.mark.parametrize('command,prefix', [
+    ('', 'list_'),
+    ('', 'zzz'),
+    ('get_attr', 'tags.focus.'),
+    ('get_attr', 'tags.focus.c'),
+    ('get_attr', 'settings.frame_b'),
+    ('attr', 'monitors.'),
+    ('keybind', 'Mod1+s'),
+])
+def test_complete_prefix(hlwm, command, prefix):
+    # the candidates are looked up by their prefix, which must give the same
+    # result as filtering all candidates
+    if command == '':
+        position = 0
+        everything = hlwm.complete([], partial=True, position=0)
+    else:
+        position = 1
+        stem = prefix[:prefix.rfind('.') + 1] if command != 'keybind' else 'Mod1+'
+        everything = hlwm.complete([command, stem], partial=True, position=1)
+    args = [prefix] if command == '' else [command, prefix]
+    completions = hlwm.complete(args, partial=True, position=position)
+    assert completions == [c for c in everything if c.startswith(prefix)]
@@ -1,6 +1,9 @@
+import json
 import subprocess
 import os
 import re
+import socket
+import struct
 import pytest
 
 HC_PATH = os.path.join(os.path.abspath(os.environ['PWD']), 'herbstclient')
@@ -114,3 +117,303 @@ def test_lastarg_only(hlwm):
     proc.wait(3)
     assert proc.returncode == 0
     assert proc.stdout.read().splitlines() == expected_lines
+
+
+def test_socket_is_announced(hlwm, x11):
+    path = x11.get_property('__HERBST_IPC_SOCKET')
+    assert path is not None
+    assert os.path.exists(path.decode())
+
+    hc = subprocess.run([HC_PATH, 'echo', 'via', 'socket'],
+                        stdout=subprocess.PIPE,
+                        universal_newlines=True,
+                        check=True)
+    assert hc.stdout == 'via socket\n'
+
+
+def test_fallback_to_properties_on_stale_socket(hlwm, x11):
+    x11.set_property_textlist('__HERBST_IPC_SOCKET', ['/nonexistent/socket'])
+    x11.display.sync()
+
+    hc = subprocess.run([HC_PATH, 'echo', 'via', 'properties'],
+                        stdout=subprocess.PIPE,
+                        universal_newlines=True,
+                        check=True)
+    assert hc.stdout == 'via properties\n'
+
+
+def test_socket_of_other_instance_is_not_used(hlwm, x11):
+    # pretend that the socket belongs to another herbstluftwm
+    x11.set_property_textlist('__HERBST_IPC_TOKEN', ['0123456789abcdef'])
+    x11.display.sync()
+
+    hc = subprocess.run([HC_PATH, 'echo', 'via', 'properties'],
+                        stdout=subprocess.PIPE,
+                        universal_newlines=True,
+                        check=True)
+    assert hc.stdout == 'via properties\n'
+    # JSON output is only available via the socket
+    hc = subprocess.run([HC_PATH, '--json', 'get_attr', 'tags.count'],
+                        stdout=subprocess.PIPE,
+                        stderr=subprocess.PIPE,
+                        universal_newlines=True)
+    assert hc.returncode != 0
+
+
+@pytest.mark.parametrize('delim', ['\n', '\0'])
+def test_batch_mode(hlwm, delim):
+    commands = [
+        'echo foo "bar baz"',
+        '',
+        'add new\\ tag',
+        'attr tags.by-name.new\\ tag.name',
+        'this_command_does_not_exist',
+    ]
+    cmd = [HC_PATH, '--batch']
+    if delim == '\0':
+        cmd.append('--print0')
+    result = subprocess.run(cmd,
+                            input=delim.join(commands),
+                            stdout=subprocess.PIPE,
+                            universal_newlines=True)
+
+    frames = []
+    remaining = result.stdout
+    while remaining:
+        header, remaining = remaining.split('\n', 1)
+        status, length = header.split(' ')
+        frames.append((int(status), remaining[:int(length)]))
+        remaining = remaining[int(length):]
+    assert frames[0] == (0, 'foo bar baz\n')
+    assert frames[1] == (0, '')
+    assert frames[2] == (0, 'new tag')
+    assert frames[3][0] == 2  # HERBST_COMMAND_NOT_FOUND
+    assert len(frames) == 4
+    assert result.returncode == 2
+
+
+def test_batch_mode_keeps_order_of_pipelined_commands(hlwm):
+    # more commands than herbstclient keeps in flight at once
+    count = 300
+    commands = ['echo {}'.format(i) for i in range(count)]
+    result = subprocess.run([HC_PATH, '--batch'],
+                            input='\n'.join(commands),
+                            stdout=subprocess.PIPE,
+                            universal_newlines=True,
+                            check=True)
+
+    expected = ''.join(['0 {}\n{}\n'.format(len(str(i)) + 1, i)
+                        for i in range(count)])
+    assert result.stdout == expected
+
+
+def test_batch_mode_answers_while_stdin_is_open(hlwm):
+    proc = subprocess.Popen([HC_PATH, '--batch'],
+                            stdin=subprocess.PIPE,
+                            stdout=subprocess.PIPE,
+                            universal_newlines=True)
+    # both lines arrive at once, so the second is buffered already
+    # while the first is answered
+    proc.stdin.write('echo foo\necho bar\n')
+    proc.stdin.flush()
+    assert [proc.stdout.readline() for _ in range(4)] \
+        == ['0 4\n', 'foo\n', '0 4\n', 'bar\n']
+
+    proc.stdin.close()
+    assert proc.wait() == 0
+
+
+class HookSubscriber:
+    """a raw subscriber to the hooks on the ipc socket"""
+    HEADER = struct.Struct('=IIiI')
+    MSG_REPLY = 2
+    MSG_SUBSCRIBE = 3
+    MSG_HOOK = 4
+    MSG_HOOKS_LOST = 5
+    MSG_HELLO = 6
+
+    def __init__(self, path, hook_filter=[]):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        msg_type, _, _, _ = self.next_message()
+        assert msg_type == self.MSG_HELLO
+        payload = b''.join([f.encode() + b'\0' for f in hook_filter])
+        self.sock.sendall(self.HEADER.pack(self.MSG_SUBSCRIBE, 0, 0, len(payload)))
+        self.sock.sendall(payload)
+        msg_type, _, self.status, _ = self.next_message()
+        assert msg_type == self.MSG_REPLY
+
+    def read_exactly(self, length):
+        data = b''
+        while len(data) < length:
+            chunk = self.sock.recv(length - len(data))
+            assert chunk
+            data += chunk
+        return data
+
+    def next_message(self):
+        header = self.read_exactly(self.HEADER.size)
+        msg_type, msg_id, status, length = self.HEADER.unpack(header)
+        payload = self.read_exactly(length)
+        return msg_type, msg_id, status, payload
+
+
+def test_overlong_socket_message_closes_connection(hlwm, x11):
+    path = x11.get_property('__HERBST_IPC_SOCKET').decode()
+    sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    sock.settimeout(10)
+    sock.connect(path)
+    # the greeting with the token
+    header = sock.recv(HookSubscriber.HEADER.size)
+    _, _, _, length = HookSubscriber.HEADER.unpack(header)
+    sock.recv(length)
+    msg_call = 1
+    sock.sendall(HookSubscriber.HEADER.pack(msg_call, 0, 0, 2**31))
+
+    # the server does not wait for the payload but hangs up
+    assert sock.recv(1) == b''
+    assert hlwm.call('echo alive').stdout == 'alive\n'
+
+
+def test_hooks_on_socket_are_numbered(hlwm, x11):
+    path = x11.get_property('__HERBST_IPC_SOCKET').decode()
+    subscriber = HookSubscriber(path)
+
+    hlwm.call('emit_hook foo bar')
+    hlwm.call('emit_hook baz')
+
+    assert subscriber.next_message() == \
+        (HookSubscriber.MSG_HOOK, 0, 0, b'foo\0bar\0')
+    assert subscriber.next_message() == \
+        (HookSubscriber.MSG_HOOK, 1, 0, b'baz\0')
+
+
+def test_hooks_on_socket_are_filtered(hlwm, x11):
+    path = x11.get_property('__HERBST_IPC_SOCKET').decode()
+    subscriber = HookSubscriber(path, ['^tag', 'b'])
+    assert subscriber.status == 0
+
+    hlwm.call('emit_hook tag_foo abc')
+    hlwm.call('emit_hook mytag abc')
+    hlwm.call('emit_hook tag_bar xyz')
+    hlwm.call('emit_hook tag_baz')
+    hlwm.call('emit_hook end')
+    subscriber_all = HookSubscriber(path)
+    hlwm.call('emit_hook tag_done b')
+
+    # only the matching hooks are sent, and they are numbered without gaps
+    assert subscriber.next_message() == \
+        (HookSubscriber.MSG_HOOK, 0, 0, b'tag_foo\0abc\0')
+    assert subscriber.next_message() == \
+        (HookSubscriber.MSG_HOOK, 1, 0, b'tag_baz\0')
+    assert subscriber.next_message() == \
+        (HookSubscriber.MSG_HOOK, 2, 0, b'tag_done\0b\0')
+    assert subscriber_all.next_message() == \
+        (HookSubscriber.MSG_HOOK, 0, 0, b'tag_done\0b\0')
+
+
+def test_invalid_hook_filter_is_rejected(hlwm, x11):
+    path = x11.get_property('__HERBST_IPC_SOCKET').decode()
+    subscriber = HookSubscriber(path, ['(unmatched'])
+    assert subscriber.status != 0
+
+
+def test_slow_hook_subscriber_is_told_about_lost_hooks(hlwm, x11):
+    path = x11.get_property('__HERBST_IPC_SOCKET').decode()
+    subscriber = HookSubscriber(path)
+    # emit way more hooks than are buffered, without reading them
+    count = 3000
+    commands = ['emit_hook flood {} {}'.format(i, 'x' * 1000)
+                for i in range(count)]
+    subprocess.run([HC_PATH, '--batch'],
+                   input='\n'.join(commands),
+                   stdout=subprocess.DEVNULL,
+                   check=True)
+
+    # every hook is either received or reported lost, in order
+    expected_seq = 0
+    lost_count = 0
+    while expected_seq < count:
+        msg_type, msg_id, status, payload = subscriber.next_message()
+        assert msg_id == expected_seq
+        if msg_type == HookSubscriber.MSG_HOOK:
+            assert payload.split(b'\0')[1] == str(msg_id).encode()
+            expected_seq += 1
+        else:
+            assert msg_type == HookSubscriber.MSG_HOOKS_LOST
+            assert status > 0
+            expected_seq += status
+            lost_count += status
+    assert expected_seq == count
+    assert lost_count > 0
+
+
+def hc_json(*args):
+    result = subprocess.run([HC_PATH, '--json'] + list(args),
+                            stdout=subprocess.PIPE,
+                            universal_newlines=True,
+                            check=True)
+    return json.loads(result.stdout)
+
+
+def test_json_output_of_attributes(hlwm):
+    hlwm.call('add foo')
+    hlwm.call(['set_attr', 'tags.0.name', 'quote"d'])
+
+    assert hc_json('get_attr', 'tags.0.name') == 'quote"d'
+    assert hc_json('get_attr', 'tags.count') == 2
+    assert hc_json('attr', 'tags.focus.floating') is False
+    tags = hc_json('attr', 'tags')
+    assert tags['children'] == ['0', '1', 'by-name', 'focus']
+    assert tags['attributes'] == {'count': 2}
+    assert hc_json('get_attrs', 'tags.count', 'tags.[0-9].index', 'tags.x') == {
+        'values': {'tags.count': 2, 'tags.0.index': 0, 'tags.1.index': 1},
+        'errors': {'tags.x': 'Object "tags" has no attribute "x"'},
+    }
+
+
+def test_json_output_of_monitors_and_tags(hlwm):
+    hlwm.call('add foo')
+
+    monitors = hc_json('list_monitors')
+    assert len(monitors) == 1
+    assert monitors[0]['index'] == 0
+    assert monitors[0]['tag'] == hlwm.get_attr('tags.focus.name')
+    assert monitors[0]['focused'] is True
+    assert monitors[0]['locked'] is False
+    assert set(monitors[0]['geometry'].keys()) == {'x', 'y', 'width', 'height'}
+
+    assert hc_json('tag_status') == [
+        {'name': hlwm.get_attr('tags.0.name'), 'status': '#'},
+        {'name': 'foo', 'status': '.'},
+    ]
+
+
+@pytest.mark.parametrize('command', ['dump', 'layout'])
+def test_json_output_of_layout(hlwm, command):
+    hlwm.call('split horizontal 0.3')
+    winid, _ = hlwm.create_client()
+
+    layout = hc_json(command)
+    assert layout['type'] == 'split'
+    assert layout['align'] == 'horizontal'
+    assert layout['fraction'] == 0.3
+    assert [c['type'] for c in layout['children']] == ['clients', 'clients']
+    assert layout['children'][0]['clients'] == [winid]
+    assert layout['children'][0]['focused'] is True
+    assert layout['children'][1]['clients'] == []
+
+
+def test_json_output_of_stack(hlwm):
+    stack = hc_json('stack')
+    monitors = stack['children']
+    assert len(monitors) == 1
+    assert len(monitors[0]['children']) > 0
+
+
+def test_json_output_falls_back_to_text(hlwm):
+    result = subprocess.run([HC_PATH, '--json', 'echo', 'foo'],
+                            stdout=subprocess.PIPE,
+                            universal_newlines=True,
+                            check=True)
+    assert result.stdout == 'foo\n'
@@ -1,6 +1,8 @@
 import re
+import json
 import os
 import subprocess
+import pytest
 from conftest import BINDIR
 
 
@@ -25,3 +27,177 @@ def test_herbstluftwm_default_autostart(hlwm):
     assert hlwm.list_children('tags.by-name') == sorted(expected_tags)
     # Test a random setting different from the default in settings.h:
     assert hlwm.get_attr('settings.smart_frame_surroundings') == 'true'
+
+
+def test_mainloop_counters(hlwm):
+    events_before = int(hlwm.get_attr('debug.mainloop.events'))
+    saved_before = int(hlwm.get_attr('debug.mainloop.roundtrips_saved'))
+    hlwm.create_client()
+
+    events = int(hlwm.get_attr('debug.mainloop.events')) - events_before
+    assert events > 0
+    assert int(hlwm.get_attr('debug.mainloop.iterations')) > 0
+    # at least the XSync() after each event is saved
+    saved = int(hlwm.get_attr('debug.mainloop.roundtrips_saved')) - saved_before
+    assert saved >= events
+
+
+def test_event_handler_timing(hlwm):
+    assert hlwm.get_attr('debug.events.enabled') == 'false'
+    hlwm.create_client()
+    assert hlwm.get_attr('debug.events.MapRequest.calls') == '0'
+
+    hlwm.call('set_attr debug.events.enabled on')
+    hlwm.create_client()
+
+    calls = int(hlwm.get_attr('debug.events.MapRequest.calls'))
+    assert calls == 1
+    histogram = hlwm.get_attr('debug.events.MapRequest.histogram').split(' ')
+    assert sum([int(n) for n in histogram]) == calls
+    total = int(hlwm.get_attr('debug.events.MapRequest.total_us'))
+    assert int(hlwm.get_attr('debug.events.MapRequest.max_us')) <= total
+
+    hlwm.call('set_attr debug.events.reset yes')
+    assert hlwm.get_attr('debug.events.MapRequest.calls') == '0'
+    assert hlwm.get_attr('debug.events.MapRequest.histogram') == ''
+
+
+@pytest.mark.parametrize('defer', [True, False])
+def test_layout_deferred_within_chain(hlwm, defer):
+    hlwm.call(['set_attr', 'debug.layout.defer', hlwm.bool(defer)])
+    requested = int(hlwm.get_attr('debug.layout.requested'))
+    executed = int(hlwm.get_attr('debug.layout.executed'))
+
+    hlwm.call('chain , set_attr monitors.0.pad_up 5 , '
+              + 'set_attr monitors.0.pad_down 6 , set_attr monitors.0.pad_left 7')
+
+    assert int(hlwm.get_attr('debug.layout.requested')) == requested + 3
+    new_executed = int(hlwm.get_attr('debug.layout.executed')) - executed
+    assert new_executed == (1 if defer else 3)
+
+
+def test_transaction_layouts_once(hlwm):
+    hlwm.call('set_attr debug.layout.defer false')
+    executed = int(hlwm.get_attr('debug.layout.executed'))
+
+    hlwm.call('transaction , set_attr monitors.0.pad_up 5 , '
+              + 'split explode , set_attr monitors.0.pad_left 7')
+
+    assert int(hlwm.get_attr('debug.layout.executed')) == executed + 1
+    assert hlwm.get_attr('tags.0.frame_count') == '2'
+
+
+def test_theme_change_relayouts_once(hlwm):
+    hlwm.call('set_attr debug.layout.defer false')
+    requested = int(hlwm.get_attr('debug.layout.requested'))
+
+    # this changes the color of every decoration scheme, but the queued
+    # theme signal is delivered only once
+    hlwm.call('set_attr theme.color #ff0000')
+
+    assert int(hlwm.get_attr('debug.layout.requested')) == requested + 1
+    assert hlwm.get_attr('theme.tiling.active.color') == '#ff0000'
+
+
+def test_relayout_all_monitors_at_once(hlwm, x11):
+    hlwm.call('add tag2')
+    win1, _ = x11.create_client()
+    hlwm.call('add_monitor 800x600+800+0 tag2')
+    hlwm.call('focus_monitor 1')
+    win2, _ = x11.create_client()
+    executed = int(hlwm.get_attr('debug.layout.executed'))
+
+    hlwm.call('set_attr theme.border_width 5')
+
+    assert int(hlwm.get_attr('debug.layout.executed')) == executed + 2
+    # the client windows are placed within their decoration windows
+    assert win1.get_geometry().x == 5
+    assert win2.get_geometry().x == 5
+
+
+def test_relayout_skips_unchanged_windows(hlwm):
+    hlwm.create_clients(2)
+    configured = int(hlwm.get_attr('debug.layout.windows_configured'))
+    unchanged = int(hlwm.get_attr('debug.layout.windows_unchanged'))
+
+    # this relayouts all monitors, but neither the geometry nor the
+    # decoration of the tiled clients changes
+    hlwm.call('set_attr theme.floating.color red')
+
+    assert int(hlwm.get_attr('debug.layout.windows_configured')) == configured
+    assert int(hlwm.get_attr('debug.layout.windows_unchanged')) == unchanged + 2
+
+    # a changed decoration has to be redrawn, even at the same geometry
+    hlwm.call('set_attr theme.background_color red')
+
+    assert int(hlwm.get_attr('debug.layout.windows_configured')) == configured + 2
+
+
+def test_relayout_reuses_layout_buffers(hlwm):
+    hlwm.create_clients(3)
+    hlwm.call('split explode')
+    assert int(hlwm.get_attr('debug.layout.buffer_growths')) > 0
+    # the first relayout with a new rectangle may still enlarge buffers
+    hlwm.call('set_attr monitors.0.pad_up 5')
+    growths = int(hlwm.get_attr('debug.layout.buffer_growths'))
+    executed = int(hlwm.get_attr('debug.layout.executed'))
+
+    for pad in [6, 7, 5, 8]:
+        # a new rectangle invalidates the layout of every frame
+        hlwm.call(['set_attr', 'monitors.0.pad_up', str(pad)])
+
+    assert int(hlwm.get_attr('debug.layout.executed')) == executed + 4
+    assert int(hlwm.get_attr('debug.layout.buffer_growths')) == growths
+
+
+def test_query_replies_reused_until_command(hlwm):
+    hlwm.call('add tag2')
+    hits = int(hlwm.get_attr('debug.queries.hits'))
+    misses = int(hlwm.get_attr('debug.queries.misses'))
+
+    status = hlwm.call('tag_status').stdout
+    assert hlwm.call('tag_status').stdout == status
+    assert int(hlwm.get_attr('debug.queries.hits')) == hits + 1
+    assert int(hlwm.get_attr('debug.queries.misses')) == misses + 1
+
+    hlwm.call('use tag2')
+
+    assert hlwm.call('tag_status').stdout != status
+    assert int(hlwm.get_attr('debug.queries.misses')) == misses + 2
+
+
+@pytest.mark.parametrize('query', [
+    'snapshot',
+    'object_tree',
+    'attr',
+    'get_attrs *.mainloop.iterations',
+    'get_attrs debug.mainloop.iterations',
+])
+def test_query_with_debug_values_not_reused(hlwm, query):
+    hits = int(hlwm.get_attr('debug.queries.hits'))
+
+    hlwm.call(query)
+    hlwm.call(query)
+
+    assert int(hlwm.get_attr('debug.queries.hits')) == hits
+
+
+def test_snapshot_shows_current_debug_values(hlwm):
+    def iterations():
+        proc = hlwm.call('snapshot')
+        snapshot = json.loads(proc.stdout)
+        debug = snapshot['children']['debug']['children']
+        return int(debug['mainloop']['attributes']['iterations'])
+
+    first = iterations()
+    assert iterations() > first
+
+
+def test_query_cache_disabled(hlwm):
+    hlwm.call('set_attr debug.queries.cache false')
+    hits = int(hlwm.get_attr('debug.queries.hits'))
+
+    hlwm.call('tag_status')
+    hlwm.call('tag_status')
+
+    assert int(hlwm.get_attr('debug.queries.hits')) == hits
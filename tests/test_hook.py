@@ -14,3 +14,104 @@ def test_hc_idle_fixture_collects(hlwm, hc_idle):
     hlwm.call('emit_hook my_hook a')
     hlwm.call('emit_hook my_hook2 b c')
     assert hc_idle.hooks() == [['my_hook', 'a'], ['my_hook2', 'b', 'c']]
+
+
+def attribute_changes(hooks):
+    return [h for h in hooks if h[0] == 'attribute_changed']
+
+
+def test_watch_reports_changes(hlwm, hc_idle):
+    hlwm.call('add foo')
+    hlwm.call('watch tags.focus.name')
+    assert hlwm.get_attr('hooks.count') == '1'
+
+    hlwm.call('use foo')
+    hlwm.call('rename foo bar')
+
+    assert attribute_changes(hc_idle.hooks()) == [
+        ['attribute_changed', 'tags.focus.name', 'default', 'foo'],
+        ['attribute_changed', 'tags.focus.name', 'foo', 'bar'],
+    ]
+
+
+def test_watch_only_reports_actual_changes(hlwm, hc_idle):
+    hlwm.call('add foo')
+    hlwm.call('watch tags.focus.name')
+    hlwm.call('watch tags.focus.name')  # only counts another watcher
+
+    hlwm.call('chain , use foo , use default')
+    hlwm.call('use default')
+
+    assert attribute_changes(hc_idle.hooks()) == []
+
+
+def test_unwatch(hlwm, hc_idle):
+    hlwm.call('add foo')
+    hlwm.call('watch tags.focus.name')
+    hlwm.call('unwatch tags.focus.name')
+    assert hlwm.get_attr('hooks.count') == '0'
+
+    hlwm.call('use foo')
+
+    assert attribute_changes(hc_idle.hooks()) == []
+    hlwm.call_xfail('unwatch tags.focus.name') \
+        .expect_stderr('is not watched')
+
+
+def test_unwatched_attribute_changes_later(hlwm, hc_idle):
+    hlwm.call('add foo')
+    hlwm.call('watch tags.1.name')
+    hlwm.call('unwatch tags.1.name')
+
+    # the removed watch must not be told about this change anymore
+    hlwm.call('rename foo bar')
+
+    assert hlwm.get_attr('tags.1.name') == 'bar'
+    assert attribute_changes(hc_idle.hooks()) == []
+
+
+def test_watch_follows_replaced_attribute(hlwm, hc_idle):
+    hlwm.call('add foo')
+    hlwm.call('watch tags.1.name')
+
+    hlwm.call('merge_tag foo')
+    hlwm.call('add baz')
+    hlwm.call('rename baz qux')
+
+    assert attribute_changes(hc_idle.hooks()) == [
+        ['attribute_changed', 'tags.1.name', 'foo', 'baz'],
+        ['attribute_changed', 'tags.1.name', 'baz', 'qux'],
+    ]
+
+
+def test_watch_counts_watchers(hlwm, hc_idle):
+    hlwm.call('add foo')
+    hlwm.call('watch tags.focus.name')
+    hlwm.call('watch tags.count')
+    hlwm.call('watch tags.focus.name')
+    assert hlwm.get_attr('hooks.count') == '2'
+    assert hlwm.get_attr('hooks.0.path') == 'tags.focus.name'
+    assert hlwm.get_attr('hooks.0.watchers') == '2'
+
+    # the other watcher still watches the attribute
+    hlwm.call('unwatch tags.focus.name')
+    hlwm.call('use foo')
+    assert attribute_changes(hc_idle.hooks()) == [
+        ['attribute_changed', 'tags.focus.name', 'default', 'foo'],
+    ]
+    assert hlwm.get_attr('hooks.0.counter') == '1'
+
+    hlwm.call('unwatch tags.focus.name')
+    assert hlwm.get_attr('hooks.count') == '1'
+    assert hlwm.get_attr('hooks.0.path') == 'tags.count'
+
+
+def test_transaction_defers_hooks(hlwm, hc_idle):
+    hlwm.call('transaction , emit_hook a , emit_hook b , emit_hook a')
+    assert hc_idle.hooks() == [['b'], ['a']]
+
+
+def test_transaction_passes_exit_code(hlwm, hc_idle):
+    proc = hlwm.unchecked_call('transaction , emit_hook a , false')
+    assert proc.returncode == 1
+    assert hc_idle.hooks() == [['a']]
@@ -384,6 +384,66 @@ def test_smart_window_surroundings(hlwm, x11):
     assert geo1.height + geo2.height + 3 * window_gap == mon_height
 
 
+def test_layout_recomputed_after_changes(hlwm, x11):
+    def geometry(win):
+        geo = win.get_geometry()
+        return (geo.x, geo.y, geo.width, geo.height)
+
+    hlwm.call('set_layout vertical')
+    win1, _ = x11.create_client()
+    win2, _ = x11.create_client()
+    hlwm.call('split horizontal 0.5')
+    win3, _ = x11.create_client()
+    initial = geometry(win1)
+
+    # the layout of the untouched frame is reused, but follows the settings
+    hlwm.call('focus right')
+    hlwm.call('focus left')
+    assert geometry(win1) == initial
+    hlwm.call('set window_gap 10')
+    assert geometry(win1) != initial
+    hlwm.call('set window_gap 0')
+    assert geometry(win1) == initial
+
+    hlwm.call('set_layout horizontal')
+    assert geometry(win1) != initial
+    hlwm.call('set_layout vertical')
+    assert geometry(win1) == initial
+
+
+def test_frame_of_client_tracked_across_changes(hlwm):
+    wins = hlwm.create_clients(5)
+    hlwm.call('load (split horizontal:0.5:0 (clients vertical:0 {} {}) '
+              '(split vertical:0.5:0 (clients max:0 {} {}) '
+              '(clients grid:0 {})))'.format(*wins))
+
+    def expect_position(winid, windex, wcount):
+        hlwm.call(['jumpto', winid])
+        assert hlwm.get_attr('clients.focus.winid') == winid
+        assert hlwm.get_attr('tags.0.curframe_windex') == str(windex)
+        assert hlwm.get_attr('tags.0.curframe_wcount') == str(wcount)
+
+    expect_position(wins[1], 1, 2)
+    expect_position(wins[3], 1, 2)
+    expect_position(wins[4], 0, 1)
+
+    # move the first client to the focused frame on the right
+    hlwm.call(['jumpto', wins[0]])
+    hlwm.call('shift right')
+    expect_position(wins[1], 0, 1)
+    expect_position(wins[0], 1, 2)
+
+    hlwm.call('rotate')
+    expect_position(wins[0], 1, 2)
+
+    # merge the clients of the focused frame into its neighbour
+    hlwm.call('remove')
+    for winid in wins:
+        hlwm.call(['jumpto', winid])
+        assert hlwm.get_attr('clients.focus.winid') == winid
+    assert int(hlwm.get_attr('tags.0.frame_count')) == 2
+
+
 @pytest.mark.parametrize('running_clients_num,start_idx_range', [
     # number of clients and indices where we should start
     (6, range(0, 6)),
@@ -1,3 +1,4 @@
+import json
 import pytest
 import re
 
@@ -37,6 +38,88 @@ def test_object_tree(hlwm):
     assert len(t2) > len(t3)
 
 
+def test_get_attr_follows_tree_changes(hlwm):
+    # the first call makes herbstluftwm remember the path
+    assert hlwm.get_attr('tags.focus.name') == 'default'
+    hlwm.call('add othertag')
+    hlwm.call('use othertag')
+    assert hlwm.get_attr('tags.focus.name') == 'othertag'
+
+    hlwm.call('new_attr string tags.focus.my_foo')
+    hlwm.call('set_attr tags.focus.my_foo bar')
+    assert hlwm.get_attr('tags.focus.my_foo') == 'bar'
+    hlwm.call('remove_attr tags.focus.my_foo')
+    hlwm.call_xfail('get_attr tags.focus.my_foo') \
+        .expect_stderr('has no attribute "my_foo"')
+
+    assert hlwm.get_attr('tags.by-name.othertag.name') == 'othertag'
+    hlwm.call('use default')
+    hlwm.call('merge_tag othertag')
+    hlwm.call_xfail('get_attr tags.by-name.othertag.name') \
+        .expect_stderr('No such object tags.by-name.othertag')
+
+
+@pytest.mark.parametrize('object_path', ['settings', 'monitors.0', 'theme.tiling.active'])
+def test_attr_listing_matches_get_attr(hlwm, object_path):
+    hlwm.call('set_attr settings.frame_border_active_color #1a2b3c')
+    listing = hlwm.call(['attr', object_path + '.']).stdout
+    values = re.findall(r'^ . . . ([^ ]*) = (.*)$', listing, re.MULTILINE)
+    assert values
+    for name, value in values:
+        expected = hlwm.get_attr(object_path + '.' + name)
+        assert value in [expected, '"' + expected + '"']
+    assert hlwm.get_attr('settings.frame_border_active_color') == '#1a2b3c'
+
+
+def test_get_attrs(hlwm):
+    hlwm.call('add foo')
+    proc = hlwm.call('get_attrs tags.count tags.focus.name')
+    assert proc.stdout == 'tags.count\t2\ntags.focus.name\tdefault\n'
+
+
+def test_get_attrs_glob(hlwm):
+    hlwm.call('add foo')
+    proc = hlwm.call('get_attrs tags.[0-9].name')
+    assert proc.stdout == 'tags.0.name\tdefault\ntags.1.name\tfoo\n'
+
+
+def test_get_attrs_reports_errors_per_path(hlwm):
+    proc = hlwm.call('get_attrs tags.count tags.nope tags.*.nope')
+    assert proc.stdout.splitlines() == [
+        'tags.count\t1',
+        'get_attrs: Object "tags" has no attribute "nope"',
+        'get_attrs: No attribute matches "tags.*.nope"',
+    ]
+
+
+def test_get_attrs_fails_if_nothing_resolves(hlwm):
+    hlwm.call_xfail('get_attrs tags.nope') \
+        .expect_stderr('get_attrs: Object "tags" has no attribute "nope"')
+
+
+def test_snapshot(hlwm):
+    hlwm.call('add foo')
+    hlwm.call('rule class=bar tag=foo')
+    snapshot = json.loads(hlwm.call('snapshot').stdout)
+
+    tags = snapshot['children']['tags']
+    assert tags['attributes'] == {'count': 2}
+    assert tags['children']['1']['attributes']['name'] == 'foo'
+    assert tags['children']['focus'] == {'link': 'tags.0'}
+    assert tags['children']['by-name']['children']['foo'] == {'link': 'tags.1'}
+    assert tags['children']['0']['layout']['type'] == 'clients'
+    rules = snapshot['children']['rules']['rules']
+    assert [c['name'] for c in rules[0]['consequences']] == ['tag']
+    assert rules[0]['conditions'][0]['value'] == 'bar'
+
+
+def test_snapshot_subtree(hlwm):
+    snapshot = json.loads(hlwm.call('snapshot tags.').stdout)
+    assert snapshot['children']['focus'] == {'link': 'tags.0'}
+    hlwm.call_xfail('snapshot foo') \
+        .expect_stderr('no child named "foo"')
+
+
 def test_substitute(hlwm):
     expected_output = hlwm.get_attr('tags.count') + '\n'
 